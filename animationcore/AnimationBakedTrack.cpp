@@ -0,0 +1,84 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationBakedTrack.h"
+
+#include <algorithm>
+#include <cmath>
+
+AnimationBakedTrack::AnimationBakedTrack()
+    : m_StartTime(0.0)
+    , m_SampleRate(1.0)
+    , m_MaxError(0.0)
+    , m_Reconstruction(Reconstruction::Linear)
+{
+}
+
+double AnimationBakedTrack::endTime() const
+{
+	return m_Samples.isEmpty() ? m_StartTime : m_StartTime + (m_Samples.size() - 1) / m_SampleRate;
+}
+
+double AnimationBakedTrack::valueAtTime(double time) const
+{
+	int count = m_Samples.size();
+	if (count == 0)
+		return 0.0;
+
+	const double *samples = m_Samples.constData();
+	double position = (time - m_StartTime) * m_SampleRate;
+	if (!(position > 0.0))
+		return samples[0];
+	if (position >= count - 1)
+		return samples[count - 1];
+
+	int index = static_cast<int>(position);
+	double f = position - index;
+	double p1 = samples[index];
+	double p2 = samples[index + 1];
+	if (m_Reconstruction == Reconstruction::Linear)
+		return p1 + (p2 - p1) * f;
+
+	// Catmull-Rom, with the end samples repeated at the edges
+	double p0 = samples[std::max(index - 1, 0)];
+	double p3 = samples[std::min(index + 2, count - 1)];
+	double c1 = 0.5 * (p2 - p0);
+	double c2 = p0 - 2.5 * p1 + 2.0 * p2 - 0.5 * p3;
+	double c3 = 0.5 * (p3 - p0) + 1.5 * (p1 - p2);
+	return p1 + f * (c1 + f * (c2 + f * c3));
+}
+
+size_t AnimationBakedTrack::memoryUsage() const
+{
+	return sizeof(AnimationBakedTrack) + m_Samples.capacity() * sizeof(double);
+}
+
+/* end of file */
@@ -0,0 +1,96 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationBakedTrack is an immutable copy of a track, sampled at a uniform
+rate into a single contiguous table. Evaluation is a multiply and an index,
+with either linear or cubic reconstruction between the samples, which suits
+runtimes that evaluate many curves per frame and never edit them.
+
+Baked tracks are created by AnimationTrack::bake, which also records the
+largest difference it measured against the source track.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_BAKED_TRACK__H
+#define ANIMATION_BAKED_TRACK__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QVector>
+
+class AnimationTrack;
+
+class ANIMATIONCORE_EXPORT AnimationBakedTrack
+{
+public:
+	enum class Reconstruction
+	{
+		Linear,
+		Cubic, // Catmull-Rom, passes through the samples
+	};
+
+	AnimationBakedTrack();
+
+	// Getters
+	double startTime() const { return m_StartTime; }
+	double endTime() const;
+	double sampleRate() const { return m_SampleRate; }
+	int sampleCount() const { return m_Samples.size(); }
+	const double *samples() const { return m_Samples.constData(); }
+	Reconstruction reconstruction() const { return m_Reconstruction; }
+	bool isEmpty() const { return m_Samples.isEmpty(); }
+
+	// Evaluation, clamped to the first and last sample like the source track
+	double valueAtTime(double time) const;
+
+	// Largest difference against the source track, measured at four points per sample interval when baking
+	double maxError() const { return m_MaxError; }
+
+	// Approximate memory used, including the object itself
+	size_t memoryUsage() const;
+
+private:
+	friend AnimationTrack;
+
+	QVector<double> m_Samples;
+	double m_StartTime;
+	double m_SampleRate;
+	double m_MaxError;
+	Reconstruction m_Reconstruction;
+
+}; /* class AnimationBakedTrack */
+
+#endif /* ANIMATION_BAKED_TRACK__H */
+
+/* end of file */
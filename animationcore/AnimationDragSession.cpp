@@ -0,0 +1,246 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationDragSession.h"
+
+#include <QHash>
+#include <algorithm>
+
+#include "AnimationTrack.h"
+#include "AnimationKeyframeIndex.h"
+
+AnimationDragSession::AnimationDragSession()
+    : m_Target(Target::Keyframes)
+    , m_TimeDelta(0.0)
+    , m_ValueDelta(0.0)
+    , m_Active(false)
+{
+}
+
+void AnimationDragSession::begin(const QList<AnimationTrack *> &tracks, const QSet<ptrdiff_t> &ids, Target target)
+{
+	reset(target);
+	m_Active = true;
+
+	if (ids.isEmpty())
+		return;
+
+	for (AnimationTrack *track : tracks)
+	{
+		TrackSelection selection;
+		selection.Track = track;
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
+		const ptrdiff_t *keyframeIds = keyframes.ids();
+		for (int i = 0; i < keyframes.size(); ++i)
+		{
+			if (ids.contains(keyframeIds[i]))
+				selection.Keyframes.append(qMakePair(keyframes.time(i), keyframes.keyframe(i)));
+		}
+		if (!selection.Keyframes.isEmpty())
+			m_Selections.append(selection);
+	}
+}
+
+void AnimationDragSession::begin(const AnimationKeyframeIndex &index, const QSet<ptrdiff_t> &ids, Target target)
+{
+	reset(target);
+	m_Active = true;
+
+	QHash<AnimationTrack *, int> selections;
+	for (ptrdiff_t id : ids)
+	{
+		AnimationKeyframeIndex::Location location = index.location(id);
+		if (!location.Track)
+			continue;
+
+		int selection = selections.value(location.Track, -1);
+		if (selection == -1)
+		{
+			selection = m_Selections.size();
+			selections.insert(location.Track, selection);
+			m_Selections.append(TrackSelection());
+			m_Selections.last().Track = location.Track;
+		}
+		const AnimationKeyframeArray &keyframes = location.Track->keyframeArray();
+		m_Selections[selection].Keyframes.append(qMakePair(location.Time, keyframes.keyframe(keyframes.indexOf(location.Time))));
+	}
+
+	for (TrackSelection &selection : m_Selections)
+	{
+		std::sort(selection.Keyframes.begin(), selection.Keyframes.end(), [](const QPair<double, AnimationKeyframe> &a, const QPair<double, AnimationKeyframe> &b) {
+			return a.first < b.first;
+		});
+	}
+}
+
+void AnimationDragSession::apply(double timeDelta, double valueDelta)
+{
+	if (!m_Active || (timeDelta == m_TimeDelta && valueDelta == m_ValueDelta))
+		return;
+
+	for (TrackSelection &selection : m_Selections)
+	{
+		AnimationTrack::EditScope editScope(selection.Track);
+		if (m_Target == Target::Keyframes)
+			moveKeyframes(selection, timeDelta, valueDelta);
+		else
+			moveHandles(selection, timeDelta, valueDelta);
+	}
+
+	m_TimeDelta = timeDelta;
+	m_ValueDelta = valueDelta;
+}
+
+void AnimationDragSession::moveKeyframes(TrackSelection &selection, double timeDelta, double valueDelta)
+{
+	AnimationTrack *track = selection.Track;
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+
+	// All the keyframes move the same way, moving the one in front first always
+	// frees the destination of the next one, unless it is an unselected keyframe
+	int count = selection.Keyframes.size();
+	bool forward = timeDelta < m_TimeDelta;
+	for (int n = 0; n < count; ++n)
+	{
+		const QPair<double, AnimationKeyframe> &original = selection.Keyframes[forward ? n : count - 1 - n];
+		double fromTime = original.first + m_TimeDelta;
+		double toTime = original.first + timeDelta;
+
+		// Skip keyframes that were replaced by something else in the meantime
+		int index = keyframes.indexOf(fromTime);
+		if (index == -1 || keyframes.id(index) != original.second.Id)
+			continue;
+
+		if (toTime != fromTime)
+		{
+			int existing = keyframes.indexOf(toTime);
+			if (existing != -1)
+				selection.Replaced.append(qMakePair(toTime, keyframes.keyframe(existing)));
+			track->moveKeyframe(fromTime, toTime);
+		}
+
+		if (valueDelta != m_ValueDelta)
+		{
+			AnimationKeyframe keyframe = original.second;
+			keyframe.Value += valueDelta;
+			track->insertKeyframe(toTime, keyframe);
+		}
+	}
+
+	// Put back replaced keyframes whose time has been left again, latest first,
+	// so that a time that was taken over several times ends with the original keyframe
+	for (int i = selection.Replaced.size() - 1; i >= 0; --i)
+	{
+		const QPair<double, AnimationKeyframe> &replaced = selection.Replaced[i];
+		if (keyframes.indexOf(replaced.first) == -1)
+		{
+			track->insertKeyframe(replaced.first, replaced.second);
+			selection.Replaced.remove(i);
+		}
+	}
+}
+
+void AnimationDragSession::moveHandles(TrackSelection &selection, double timeDelta, double valueDelta)
+{
+	AnimationTrack *track = selection.Track;
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	for (const QPair<double, AnimationKeyframe> &original : selection.Keyframes)
+	{
+		int index = keyframes.indexOf(original.first);
+		if (index == -1 || keyframes.id(index) != original.second.Id)
+			continue;
+
+		AnimationKeyframe keyframe = keyframes.keyframe(index);
+		if (m_Target == Target::InHandles)
+		{
+			keyframe.Interpolation.Bezier.InTangentX = original.second.Interpolation.Bezier.InTangentX + timeDelta;
+			keyframe.Interpolation.Bezier.InTangentY = original.second.Interpolation.Bezier.InTangentY + valueDelta;
+		}
+		else
+		{
+			keyframe.Interpolation.Bezier.OutTangentX = original.second.Interpolation.Bezier.OutTangentX + timeDelta;
+			keyframe.Interpolation.Bezier.OutTangentY = original.second.Interpolation.Bezier.OutTangentY + valueDelta;
+		}
+		track->insertKeyframe(original.first, keyframe);
+	}
+}
+
+void AnimationDragSession::revert()
+{
+	if (!m_Active)
+		return;
+
+	apply(0.0, 0.0);
+
+	// Anything that is still missing, such as keyframes that landed on each other
+	for (TrackSelection &selection : m_Selections)
+	{
+		AnimationTrack::EditScope editScope(selection.Track);
+		const AnimationKeyframeArray &keyframes = selection.Track->keyframeArray();
+		for (const QPair<double, AnimationKeyframe> &original : selection.Keyframes)
+		{
+			int index = keyframes.indexOf(original.first);
+			if (index == -1 || keyframes.id(index) != original.second.Id)
+				selection.Track->insertKeyframe(original.first, original.second);
+		}
+		for (const QPair<double, AnimationKeyframe> &replaced : selection.Replaced)
+		{
+			if (keyframes.indexOf(replaced.first) == -1)
+				selection.Track->insertKeyframe(replaced.first, replaced.second);
+		}
+	}
+
+	commit();
+}
+
+void AnimationDragSession::commit()
+{
+	reset(m_Target);
+}
+
+void AnimationDragSession::reset(Target target)
+{
+	m_Selections.clear();
+	m_Target = target;
+	m_TimeDelta = 0.0;
+	m_ValueDelta = 0.0;
+	m_Active = false;
+}
+
+QList<AnimationTrack *> AnimationDragSession::tracks() const
+{
+	QList<AnimationTrack *> res;
+	for (const TrackSelection &selection : m_Selections)
+		res.append(selection.Track);
+	return res;
+}
+
+/* end of file */
@@ -0,0 +1,124 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationDragSession moves a selection of keyframes, or their Bezier
+handles, by a time and value offset from where they were when the session
+began. Only the selected keyframes are recorded, and every step moves them
+from their current position to the new one in place, so the cost of a step
+follows the size of the selection rather than the size of the tracks.
+
+Keyframes that a moved keyframe lands on are replaced as with
+AnimationTrack::moveKeyframe, but remembered by the session, and put back
+as soon as their time is free again, or when the session is reverted.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_DRAG_SESSION__H
+#define ANIMATION_DRAG_SESSION__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QSet>
+
+#include "AnimationKeyframe.h"
+
+class AnimationTrack;
+class AnimationKeyframeIndex;
+
+class ANIMATIONCORE_EXPORT AnimationDragSession
+{
+public:
+	// What the offset applies to
+	enum class Target
+	{
+		Keyframes, // Time and value of the keyframes
+		InHandles, // Bezier handle before the keyframes
+		OutHandles, // Bezier handle after the keyframes
+	};
+
+	AnimationDragSession();
+
+	// Record the keyframes with the given IDs on the tracks, the tracks must outlive the session
+	void begin(const QList<AnimationTrack *> &tracks, const QSet<ptrdiff_t> &ids, Target target = Target::Keyframes);
+
+	// Same, looking the keyframes up in the index, which costs the size of the selection rather than of the tracks
+	void begin(const AnimationKeyframeIndex &index, const QSet<ptrdiff_t> &ids, Target target = Target::Keyframes);
+
+	// Offset the recorded keyframes from their original state, replacing the previous offset
+	// Each track that holds part of the selection is edited as a single change
+	void apply(double timeDelta, double valueDelta);
+
+	// Put the keyframes and everything they replaced back as they were, and end the session
+	void revert();
+
+	// Keep the keyframes where they are, and end the session
+	void commit();
+
+	// Getters
+	bool isActive() const { return m_Active; }
+	Target target() const { return m_Target; }
+	double timeDelta() const { return m_TimeDelta; }
+	double valueDelta() const { return m_ValueDelta; }
+	QList<AnimationTrack *> tracks() const; // Tracks that hold part of the selection
+
+private:
+	struct TrackSelection
+	{
+		AnimationTrack *Track;
+
+		// Selected keyframes as they were when the session began, sorted by time
+		QVector<QPair<double, AnimationKeyframe>> Keyframes;
+
+		// Keyframes that were replaced by a moved keyframe, waiting for their time to be free
+		QVector<QPair<double, AnimationKeyframe>> Replaced;
+	};
+
+	void reset(Target target);
+	void moveKeyframes(TrackSelection &selection, double timeDelta, double valueDelta);
+	void moveHandles(TrackSelection &selection, double timeDelta, double valueDelta);
+
+	QVector<TrackSelection> m_Selections;
+	Target m_Target;
+	double m_TimeDelta;
+	double m_ValueDelta;
+	bool m_Active;
+
+}; /* class AnimationDragSession */
+
+#endif /* ANIMATION_DRAG_SESSION__H */
+
+/* end of file */
@@ -0,0 +1,675 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationEvaluator holds the evaluation kernels of one interpolation method
+for one scalar type, selected at compile time, so the sampling loops do not
+branch on the interpolation method. The kernels work on plain arrays of
+keyframe times with their precomputed segments, described by an
+AnimationCurveView, and only depend on AnimationKeyframe, so they can be used
+in a runtime without QObject. AnimationTrack and AnimationTrackSnapshot
+evaluate through them.
+
+Use dispatchAnimationEvaluator to pick the evaluator for an interpolation
+method that is only known at runtime, once per batch of samples.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_EVALUATOR__H
+#define ANIMATION_EVALUATOR__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "AnimationKeyframe.h"
+
+// SSE2 is always available on x86-64, other targets use the scalar path
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIMATION_EVALUATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+// Segment as a cubic polynomial in normalized time, value = C0 + u * (C1 + u * (C2 + u * C3))
+// Step segments only use C0, and Linear segments C0 and C1
+template <typename T>
+struct AnimationCurveSegment
+{
+	T Time;
+	T InvDuration;
+	T C0;
+	T C1;
+	T C2;
+	T C3;
+};
+
+// Bezier segment time as a cubic of the curve parameter, u = s * (X1 + s * (X2 + s * X3)), with the handles
+// clamped to the segment so it is monotonic, the inverse table holds s and ds/du at evenly spaced u,
+// which gives an initial guess that two Newton steps refine to the result, except in the intervals flagged
+// in InverseFallback where the curve is too flat, which use the full solve
+template <typename T>
+struct AnimationBezierTiming
+{
+	static const int InverseTableSize = 8;
+	T X1;
+	T X2;
+	T X3;
+	T Inverse[InverseTableSize + 1];
+	T InverseSlope[InverseTableSize + 1];
+	unsigned int InverseFallback;
+};
+
+// Keyframes and segments to evaluate, Segments[i] spans keyframes i and i + 1
+// Timings is parallel to Segments, and only used by the Bezier evaluator
+// The curve is held at the first and last value beyond the keyframes
+template <typename T>
+struct AnimationCurveView
+{
+	const T *Times;
+	int Size;
+	T FirstValue;
+	T LastValue;
+	const AnimationCurveSegment<T> *Segments;
+	const AnimationBezierTiming<T> *Timings;
+	bool InverseTables;
+};
+
+// Single lane with the same interface as the vector registers, for the lanes left at the end of a batch
+template <typename T>
+struct AnimationScalarLanes
+{
+	typedef T Vector;
+	static const int Width = 1;
+	static Vector set(T v) { return v; }
+	static Vector index(size_t i) { return static_cast<T>(i); }
+	static Vector load(const T *p) { return *p; }
+	static void store(T *p, Vector v) { *p = v; }
+	static Vector add(Vector a, Vector b) { return a + b; }
+	static Vector sub(Vector a, Vector b) { return a - b; }
+	static Vector mul(Vector a, Vector b) { return a * b; }
+	static Vector div(Vector a, Vector b) { return a / b; }
+	static Vector sqrt(Vector a) { return std::sqrt(a); }
+	static Vector abs(Vector a) { return std::abs(a); }
+};
+
+// Vector registers used by the batched evaluation, Width is 1 when there are none for the scalar type
+template <typename T>
+struct AnimationEvaluatorLanes : AnimationScalarLanes<T>
+{
+};
+
+#ifdef ANIMATION_EVALUATOR_SSE2
+template <>
+struct AnimationEvaluatorLanes<double>
+{
+	typedef __m128d Vector;
+	static const int Width = 2;
+	static Vector set(double v) { return _mm_set1_pd(v); }
+	static Vector index(size_t i) { return _mm_set_pd(static_cast<double>(i + 1), static_cast<double>(i)); }
+	static Vector load(const double *p) { return _mm_loadu_pd(p); }
+	static void store(double *p, Vector v) { _mm_storeu_pd(p, v); }
+	static Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+	static Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+	static Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+	static Vector div(Vector a, Vector b) { return _mm_div_pd(a, b); }
+	static Vector sqrt(Vector a) { return _mm_sqrt_pd(a); }
+	static Vector abs(Vector a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+};
+
+template <>
+struct AnimationEvaluatorLanes<float>
+{
+	typedef __m128 Vector;
+	static const int Width = 4;
+	static Vector set(float v) { return _mm_set1_ps(v); }
+	static Vector index(size_t i) { return _mm_set_ps(static_cast<float>(i + 3), static_cast<float>(i + 2), static_cast<float>(i + 1), static_cast<float>(i)); }
+	static Vector load(const float *p) { return _mm_loadu_ps(p); }
+	static void store(float *p, Vector v) { _mm_storeu_ps(p, v); }
+	static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+	static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+	static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+	static Vector div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+	static Vector sqrt(Vector a) { return _mm_sqrt_ps(a); }
+	static Vector abs(Vector a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+};
+#endif
+
+template <AnimationInterpolation Method, typename T = double>
+class AnimationEvaluator
+{
+public:
+	typedef T Scalar;
+	typedef AnimationCurveSegment<T> Segment;
+	typedef AnimationBezierTiming<T> Timing;
+	typedef AnimationCurveView<T> View;
+
+	static constexpr AnimationInterpolation Interpolation = Method;
+
+	// Precompute the segment between two keyframes
+	static Segment segment(T t0, const AnimationKeyframe &k0, T t1, const AnimationKeyframe &k1);
+
+	// Precompute the time curve of a Bezier segment, the inverse table speeds up the evaluation
+	static Timing timing(T t0, const AnimationKeyframe &k0, T t1, const AnimationKeyframe &k1, bool inverseTable);
+
+	// Evaluate a single segment at a time, timing is only used by the Bezier evaluator and may be null otherwise
+	static T evaluate(const Segment &segment, const Timing *timing, T time, bool inverseTable);
+
+	// Evaluate segment index of the view at a time within it
+	static T valueAtSegment(const View &view, int index, T time);
+
+	// Evaluate the curve, clamped to the first and last keyframe
+	static T valueAtTime(const View &view, T time);
+
+	// Evaluate the curve at many times, fastest when they are ascending
+	static void sample(const View &view, const T *times, T *out, size_t count);
+
+	// Evaluate the curve at evenly spaced times, out[i] is the value at fromTime + i * timeStep
+	static void sampleRange(const View &view, T fromTime, T timeStep, size_t count, T *out);
+
+private:
+	// Tolerances of the Bezier parameter solve, on the time residual and on the width of the bracket
+	static constexpr T SolveTolerance = sizeof(T) < sizeof(double) ? T(1e-6) : T(1e-12);
+	static constexpr T BracketTolerance = sizeof(T) < sizeof(double) ? T(1e-7) : T(1e-15);
+	static constexpr T FallbackTolerance = sizeof(T) < sizeof(double) ? T(1e-5) : T(1e-10);
+
+	static T polynomial(const Segment &segment, T u);
+	template <typename Lanes>
+	static typename Lanes::Vector polynomial(const typename Lanes::Vector *c, typename Lanes::Vector u);
+
+	// Evaluate the samples that all fall within segment index
+	static void evaluateRun(const View &view, int index, const T *times, T *out, size_t count);
+	static void evaluateRange(const View &view, int index, T fromTime, T timeStep, size_t first, size_t count, T *out);
+
+	static T solveBezierParameter(const Timing &timing, T u, bool inverseTable);
+	static T solveBezierParameter(const Timing &timing, T u, T lo, T hi, T s);
+
+}; /* class AnimationEvaluator */
+
+// Call function with the evaluator for the interpolation method, so the method is switched on once rather than per sample
+//     dispatchAnimationEvaluator(method, [&](auto evaluator) { evaluator.sampleRange(view, fromTime, timeStep, count, out); });
+template <typename T = double, typename Function>
+inline decltype(auto) dispatchAnimationEvaluator(AnimationInterpolation method, Function &&function)
+{
+	switch (method)
+	{
+	case AnimationInterpolation::Step:
+		return function(AnimationEvaluator<AnimationInterpolation::Step, T>());
+	case AnimationInterpolation::Bezier:
+		return function(AnimationEvaluator<AnimationInterpolation::Bezier, T>());
+	case AnimationInterpolation::TCB:
+		return function(AnimationEvaluator<AnimationInterpolation::TCB, T>());
+	case AnimationInterpolation::EaseInOut:
+		return function(AnimationEvaluator<AnimationInterpolation::EaseInOut, T>());
+	case AnimationInterpolation::Linear:
+	default:
+		return function(AnimationEvaluator<AnimationInterpolation::Linear, T>());
+	}
+}
+
+// Convert Hermite end points and scaled tangents to the power basis
+template <typename T>
+inline void animationHermitePolynomial(AnimationCurveSegment<T> &segment, T p0, T m0, T p1, T m1)
+{
+	segment.C0 = p0;
+	segment.C1 = m0;
+	segment.C2 = T(-3.0) * p0 - T(2.0) * m0 + T(3.0) * p1 - m1;
+	segment.C3 = T(2.0) * p0 + m0 - T(2.0) * p1 + m1;
+}
+
+template <AnimationInterpolation Method, typename T>
+AnimationCurveSegment<T> AnimationEvaluator<Method, T>::segment(T t0, const AnimationKeyframe &k0, T t1, const AnimationKeyframe &k1)
+{
+	Segment segment;
+	segment.Time = t0;
+	segment.InvDuration = T(1.0) / (t1 - t0);
+
+	T v0 = T(k0.Value);
+	T v1 = T(k1.Value);
+	if constexpr (Method == AnimationInterpolation::Step)
+	{
+		segment.C0 = v0;
+		segment.C1 = T(0.0);
+		segment.C2 = T(0.0);
+		segment.C3 = T(0.0);
+	}
+	else if constexpr (Method == AnimationInterpolation::Linear)
+	{
+		segment.C0 = v0;
+		segment.C1 = v1 - v0;
+		segment.C2 = T(0.0);
+		segment.C3 = T(0.0);
+	}
+	else if constexpr (Method == AnimationInterpolation::Bezier)
+	{
+		// Value as a cubic of the curve parameter, the time is mapped to it by timing
+		// Compute the Bezier control point values (absolute)
+		T p0 = v0;
+		T p1 = v0 + T(k0.Interpolation.Bezier.OutTangentY);
+		T p2 = v1 + T(k1.Interpolation.Bezier.InTangentY);
+		T p3 = v1;
+
+		// Convert from the Bernstein basis to the power basis
+		segment.C0 = p0;
+		segment.C1 = T(3.0) * (p1 - p0);
+		segment.C2 = T(3.0) * (p0 - T(2.0) * p1 + p2);
+		segment.C3 = p3 - p0 + T(3.0) * (p1 - p2);
+	}
+	else if constexpr (Method == AnimationInterpolation::TCB)
+	{
+		// Compute the tension, continuity, and bias parameters
+		T t0_tension = (T(1.0) - T(k0.Interpolation.TCB.Tension)) * T(0.5);
+		T t1_tension = (T(1.0) - T(k1.Interpolation.TCB.Tension)) * T(0.5);
+		T t0_bias = (T(1.0) + T(k0.Interpolation.TCB.Bias)) * t0_tension;
+		T t1_bias = (T(1.0) - T(k1.Interpolation.TCB.Bias)) * t1_tension;
+		T t0_continuity = (T(1.0) - T(k0.Interpolation.TCB.Continuity)) * T(0.5);
+		T t1_continuity = (T(1.0) + T(k1.Interpolation.TCB.Continuity)) * T(0.5);
+
+		// Compute the incoming and outgoing tangents
+		T outTangent0 = (v1 - v0) * t0_bias * t0_continuity;
+		T inTangent1 = (v1 - v0) * t1_bias * t1_continuity;
+
+		animationHermitePolynomial(segment, v0, outTangent0 * (t1 - t0), v1, inTangent1 * (t1 - t0));
+	}
+	else if constexpr (Method == AnimationInterpolation::EaseInOut)
+	{
+		// Compute the incoming and outgoing tangents
+		T outTangent0 = T(k0.Interpolation.EaseInOut.EaseOut) * (v1 - v0);
+		T inTangent1 = T(k1.Interpolation.EaseInOut.EaseIn) * (v1 - v0);
+
+		animationHermitePolynomial(segment, v0, outTangent0 * (t1 - t0), v1, inTangent1 * (t1 - t0));
+	}
+
+	return segment;
+}
+
+template <AnimationInterpolation Method, typename T>
+AnimationBezierTiming<T> AnimationEvaluator<Method, T>::timing(T t0, const AnimationKeyframe &k0, T t1, const AnimationKeyframe &k1, bool inverseTable)
+{
+	const int tableSize = Timing::InverseTableSize;
+
+	// Normalized time of the inner control points, clamped to the segment, which keeps
+	// the time curve monotonic so every time maps to exactly one point on the curve
+	T duration = t1 - t0;
+	T x1 = std::clamp(T(k0.Interpolation.Bezier.OutTangentX) / duration, T(0.0), T(1.0));
+	T x2 = std::clamp(T(1.0) + T(k1.Interpolation.Bezier.InTangentX) / duration, T(0.0), T(1.0));
+
+	Timing timing;
+	timing.X1 = T(3.0) * x1;
+	timing.X2 = T(3.0) * (x2 - T(2.0) * x1);
+	timing.X3 = T(1.0) + T(3.0) * (x1 - x2);
+
+	timing.InverseFallback = 0;
+	for (int i = 0; i <= tableSize; ++i)
+	{
+		if (inverseTable)
+		{
+			// Slope of the inverse in table steps
+			T s = solveBezierParameter(timing, T(i) / tableSize, false);
+			T dx = timing.X1 + s * (T(2.0) * timing.X2 + s * T(3.0) * timing.X3);
+			timing.Inverse[i] = s;
+			timing.InverseSlope[i] = dx > T(1e-6) ? T(1.0) / (dx * tableSize) : T(0.0);
+		}
+		else
+		{
+			timing.Inverse[i] = T(0.0);
+			timing.InverseSlope[i] = T(0.0);
+		}
+	}
+
+	if (inverseTable)
+	{
+		// Flag the intervals where the fast path cannot be trusted to FallbackTolerance, either because
+		// the curve is so flat somewhere in them that the full solve itself only pins the parameter to
+		// SolveTolerance over the slope, or because the guess and the Newton steps miss the full solve
+		// at one of the probes, with a margin for the error between them
+		const int probes = 16;
+		for (int i = 0; i < tableSize; ++i)
+		{
+			T lo = timing.Inverse[i];
+			T hi = timing.Inverse[i + 1];
+			T slope = std::min(timing.X1 + lo * (T(2.0) * timing.X2 + lo * T(3.0) * timing.X3), timing.X1 + hi * (T(2.0) * timing.X2 + hi * T(3.0) * timing.X3));
+			T vertex = timing.X3 > T(0.0) ? -timing.X2 / (T(3.0) * timing.X3) : lo;
+			if (vertex > lo && vertex < hi)
+				slope = std::min(slope, timing.X1 + vertex * (T(2.0) * timing.X2 + vertex * T(3.0) * timing.X3));
+			bool fallback = slope * FallbackTolerance < T(4.0) * SolveTolerance;
+			for (int j = 1; j < probes && !fallback; ++j)
+			{
+				T u = (i + T(j) / probes) / tableSize;
+				T exact = solveBezierParameter(timing, u, lo, hi, T(0.5) * (lo + hi));
+				T fast = solveBezierParameter(timing, u, true);
+				fallback = std::abs(fast - exact) > T(0.5) * FallbackTolerance;
+			}
+			if (fallback)
+				timing.InverseFallback |= 1u << i;
+		}
+	}
+
+	return timing;
+}
+
+template <AnimationInterpolation Method, typename T>
+inline T AnimationEvaluator<Method, T>::polynomial(const Segment &segment, T u)
+{
+	if constexpr (Method == AnimationInterpolation::Step)
+		return segment.C0;
+	else if constexpr (Method == AnimationInterpolation::Linear)
+		return segment.C0 + u * segment.C1;
+	else
+		return segment.C0 + u * (segment.C1 + u * (segment.C2 + u * segment.C3));
+}
+
+template <AnimationInterpolation Method, typename T>
+template <typename Lanes>
+inline typename Lanes::Vector AnimationEvaluator<Method, T>::polynomial(const typename Lanes::Vector *c, typename Lanes::Vector u)
+{
+	if constexpr (Method == AnimationInterpolation::Linear)
+	{
+		return Lanes::add(c[0], Lanes::mul(u, c[1]));
+	}
+	else
+	{
+		typename Lanes::Vector v = Lanes::add(c[2], Lanes::mul(u, c[3]));
+		v = Lanes::add(c[1], Lanes::mul(u, v));
+		return Lanes::add(c[0], Lanes::mul(u, v));
+	}
+}
+
+template <AnimationInterpolation Method, typename T>
+inline T AnimationEvaluator<Method, T>::evaluate(const Segment &segment, const Timing *timing, T time, bool inverseTable)
+{
+	if constexpr (Method == AnimationInterpolation::Step)
+		return segment.C0;
+
+	T u = (time - segment.Time) * segment.InvDuration;
+	if constexpr (Method == AnimationInterpolation::Bezier)
+		u = solveBezierParameter(*timing, u, inverseTable);
+	return polynomial(segment, u);
+}
+
+template <AnimationInterpolation Method, typename T>
+inline T AnimationEvaluator<Method, T>::valueAtSegment(const View &view, int index, T time)
+{
+	if constexpr (Method == AnimationInterpolation::Bezier)
+		return evaluate(view.Segments[index], view.Timings + index, time, view.InverseTables);
+	else
+		return evaluate(view.Segments[index], nullptr, time, false);
+}
+
+template <AnimationInterpolation Method, typename T>
+T AnimationEvaluator<Method, T>::valueAtTime(const View &view, T time)
+{
+	if (view.Size == 0)
+		return T(0.0);
+	if (time <= view.Times[0])
+		return view.FirstValue;
+	if (time >= view.Times[view.Size - 1])
+		return view.LastValue;
+
+	int index = static_cast<int>(std::upper_bound(view.Times, view.Times + view.Size, time) - view.Times) - 1;
+	return valueAtSegment(view, index, time);
+}
+
+template <AnimationInterpolation Method, typename T>
+void AnimationEvaluator<Method, T>::sample(const View &view, const T *times, T *out, size_t count)
+{
+	int size = view.Size;
+	if (size == 0)
+	{
+		std::fill(out, out + count, T(0.0));
+		return;
+	}
+
+	const T *keyTimes = view.Times;
+	T firstTime = keyTimes[0];
+	T lastTime = keyTimes[size - 1];
+	int index = -1;
+
+	size_t i = 0;
+	while (i < count)
+	{
+		T time = times[i];
+
+		// Clamp to the first and last keyframe
+		if (time <= firstTime)
+		{
+			out[i++] = view.FirstValue;
+			continue;
+		}
+		if (time >= lastTime)
+		{
+			out[i++] = view.LastValue;
+			continue;
+		}
+
+		// Step to the next segment when the times are ascending, otherwise search
+		if (index != -1 && index + 2 < size && time >= keyTimes[index + 1] && time < keyTimes[index + 2])
+			++index;
+		else
+			index = static_cast<int>(std::upper_bound(keyTimes, keyTimes + size, time) - keyTimes) - 1;
+
+		// Evaluate the run of samples that falls within this segment at once
+		T time0 = keyTimes[index];
+		T time1 = keyTimes[index + 1];
+		size_t end = i + 1;
+		while (end < count && times[end] >= time0 && times[end] < time1)
+			++end;
+		evaluateRun(view, index, times + i, out + i, end - i);
+		i = end;
+	}
+}
+
+template <AnimationInterpolation Method, typename T>
+void AnimationEvaluator<Method, T>::sampleRange(const View &view, T fromTime, T timeStep, size_t count, T *out)
+{
+	if (timeStep < T(0.0) && count > 1)
+	{
+		// Walk the segments forward and reverse the result
+		sampleRange(view, fromTime + timeStep * (count - 1), -timeStep, count, out);
+		std::reverse(out, out + count);
+		return;
+	}
+
+	int size = view.Size;
+	if (size == 0)
+	{
+		std::fill(out, out + count, T(0.0));
+		return;
+	}
+
+	const T *keyTimes = view.Times;
+
+	// Samples before the first keyframe
+	size_t i = 0;
+	while (i < count && fromTime + i * timeStep <= keyTimes[0])
+		out[i++] = view.FirstValue;
+
+	if (i < count)
+	{
+		int index = static_cast<int>(std::upper_bound(keyTimes, keyTimes + size, fromTime + i * timeStep) - keyTimes) - 1;
+		while (i < count && index < size - 1)
+		{
+			T time1 = keyTimes[index + 1];
+
+			// Samples within this segment
+			size_t end = i;
+			while (end < count && fromTime + end * timeStep < time1)
+				++end;
+			if (end > i)
+			{
+				evaluateRange(view, index, fromTime, timeStep, i, end - i, out + i);
+				i = end;
+			}
+
+			// Skip ahead with a search when there are many keyframes between two samples
+			T nextTime = fromTime + i * timeStep;
+			if (i < count && index + 2 < size && nextTime >= keyTimes[index + 2])
+				index = static_cast<int>(std::upper_bound(keyTimes, keyTimes + size, nextTime) - keyTimes) - 1;
+			else
+				++index;
+		}
+	}
+
+	// Samples after the last keyframe
+	while (i < count)
+		out[i++] = view.LastValue;
+}
+
+template <AnimationInterpolation Method, typename T>
+void AnimationEvaluator<Method, T>::evaluateRun(const View &view, int index, const T *times, T *out, size_t count)
+{
+	const Segment &segment = view.Segments[index];
+	if constexpr (Method == AnimationInterpolation::Step)
+	{
+		std::fill(out, out + count, segment.C0);
+	}
+	else if constexpr (Method == AnimationInterpolation::Bezier)
+	{
+		for (size_t i = 0; i < count; ++i)
+			out[i] = evaluate(segment, view.Timings + index, times[i], view.InverseTables);
+	}
+	else
+	{
+		size_t i = 0;
+		typedef AnimationEvaluatorLanes<T> Lanes;
+		if constexpr (Lanes::Width > 1)
+		{
+			const typename Lanes::Vector time0 = Lanes::set(segment.Time);
+			const typename Lanes::Vector invDuration = Lanes::set(segment.InvDuration);
+			const typename Lanes::Vector c[4] = { Lanes::set(segment.C0), Lanes::set(segment.C1), Lanes::set(segment.C2), Lanes::set(segment.C3) };
+			for (; i + Lanes::Width <= count; i += Lanes::Width)
+			{
+				typename Lanes::Vector u = Lanes::mul(Lanes::sub(Lanes::load(times + i), time0), invDuration);
+				Lanes::store(out + i, polynomial<Lanes>(c, u));
+			}
+		}
+		for (; i < count; ++i)
+			out[i] = polynomial(segment, (times[i] - segment.Time) * segment.InvDuration);
+	}
+}
+
+template <AnimationInterpolation Method, typename T>
+void AnimationEvaluator<Method, T>::evaluateRange(const View &view, int index, T fromTime, T timeStep, size_t first, size_t count, T *out)
+{
+	// Times are computed from the sample index rather than accumulated, to avoid drift over long ranges
+	const Segment &segment = view.Segments[index];
+	if constexpr (Method == AnimationInterpolation::Step)
+	{
+		std::fill(out, out + count, segment.C0);
+	}
+	else if constexpr (Method == AnimationInterpolation::Bezier)
+	{
+		for (size_t i = 0; i < count; ++i)
+			out[i] = evaluate(segment, view.Timings + index, fromTime + (first + i) * timeStep, view.InverseTables);
+	}
+	else
+	{
+		size_t i = 0;
+		typedef AnimationEvaluatorLanes<T> Lanes;
+		if constexpr (Lanes::Width > 1)
+		{
+			const typename Lanes::Vector from = Lanes::set(fromTime);
+			const typename Lanes::Vector step = Lanes::set(timeStep);
+			const typename Lanes::Vector time0 = Lanes::set(segment.Time);
+			const typename Lanes::Vector invDuration = Lanes::set(segment.InvDuration);
+			const typename Lanes::Vector c[4] = { Lanes::set(segment.C0), Lanes::set(segment.C1), Lanes::set(segment.C2), Lanes::set(segment.C3) };
+			for (; i + Lanes::Width <= count; i += Lanes::Width)
+			{
+				typename Lanes::Vector time = Lanes::add(from, Lanes::mul(Lanes::index(first + i), step));
+				typename Lanes::Vector u = Lanes::mul(Lanes::sub(time, time0), invDuration);
+				Lanes::store(out + i, polynomial<Lanes>(c, u));
+			}
+		}
+		for (; i < count; ++i)
+			out[i] = polynomial(segment, (fromTime + (first + i) * timeStep - segment.Time) * segment.InvDuration);
+	}
+}
+
+template <AnimationInterpolation Method, typename T>
+T AnimationEvaluator<Method, T>::solveBezierParameter(const Timing &timing, T u, bool inverseTable)
+{
+	const int tableSize = Timing::InverseTableSize;
+	if (!inverseTable)
+		return solveBezierParameter(timing, u, T(0.0), T(1.0), u);
+
+	T position = std::clamp(u, T(0.0), T(1.0)) * tableSize;
+	int index = std::min(static_cast<int>(position), tableSize - 1);
+	T lo = timing.Inverse[index];
+	T hi = timing.Inverse[index + 1];
+	T f = position - index;
+	T m0 = timing.InverseSlope[index];
+	T m1 = timing.InverseSlope[index + 1];
+	if (m0 == T(0.0) || m1 == T(0.0))
+		return solveBezierParameter(timing, u, lo, hi, lo + (hi - lo) * f);
+
+	// Cubic Hermite interpolation between the table entries
+	T g = T(1.0) - f;
+	T s = lo * g * g * (T(1.0) + T(2.0) * f) + hi * f * f * (T(1.0) + T(2.0) * g) + (m0 * g - m1 * f) * f * g;
+	if (timing.InverseFallback & (1u << index))
+		return solveBezierParameter(timing, u, lo, hi, std::clamp(s, lo, hi));
+
+	// Two Newton steps, each with its own slope so the error keeps squaring
+	s -= (s * (timing.X1 + s * (timing.X2 + s * timing.X3)) - u) / (timing.X1 + s * (T(2.0) * timing.X2 + s * T(3.0) * timing.X3));
+	s -= (s * (timing.X1 + s * (timing.X2 + s * timing.X3)) - u) / (timing.X1 + s * (T(2.0) * timing.X2 + s * T(3.0) * timing.X3));
+	return std::clamp(s, lo, hi);
+}
+
+template <AnimationInterpolation Method, typename T>
+T AnimationEvaluator<Method, T>::solveBezierParameter(const Timing &timing, T u, T lo, T hi, T s)
+{
+	// Newton's method, kept within a bracket around the root, and falling back to
+	// bisection when a step leaves it or the curve is flat, which happens at the ends
+	// when the handles are clamped
+	for (int i = 0; i < 64; ++i)
+	{
+		T x = s * (timing.X1 + s * (timing.X2 + s * timing.X3)) - u;
+		if (std::abs(x) < SolveTolerance)
+			break;
+		if (x < T(0.0))
+			lo = s;
+		else
+			hi = s;
+		T dx = timing.X1 + s * (T(2.0) * timing.X2 + s * T(3.0) * timing.X3);
+		T next = dx > SolveTolerance ? s - x / dx : lo;
+		s = (next > lo && next < hi) ? next : T(0.5) * (lo + hi);
+		if (hi - lo < BracketTolerance)
+			break;
+	}
+	return s;
+}
+
+#endif /* ANIMATION_EVALUATOR__H */
+
+/* end of file */
@@ -0,0 +1,163 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationKeyframe holds the value and the interpolation parameters of a
+single keyframe. Tracks store keyframes in an AnimationKeyframeArray, this
+structure is used to pass individual keyframes in and out of a track.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_KEYFRAME__H
+#define ANIMATION_KEYFRAME__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <atomic>
+
+class AnimationTrack;
+class AnimationVectorTrack;
+class AnimationRotationTrack;
+
+enum class AnimationInterpolation
+{
+	Step,
+	Linear,
+	Bezier,
+	TCB,
+	EaseInOut,
+};
+
+struct ANIMATIONCORE_EXPORT AnimationKeyframe
+{
+	// Identifier for the UI
+	ptrdiff_t Id;
+
+	// Value on Y-axis
+	double Value;
+
+	// Interpolation data for different methods
+	union InterpolationData
+	{
+		// Bezier handles, relative to the keyframe
+		struct
+		{
+			double InTangentX;
+			double InTangentY;
+			double OutTangentX;
+			double OutTangentY;
+		} Bezier;
+
+		// TCB interpolation parameters
+		struct
+		{
+			double Tension;
+			double Continuity;
+			double Bias;
+		} TCB;
+
+		// Ease In/Out interpolation parameters
+		struct
+		{
+			double EaseIn;
+			double EaseOut;
+		} EaseInOut;
+	} Interpolation;
+
+	// Default null keyframe constructor
+	AnimationKeyframe()
+	    : Id(-1)
+	    , Value(0.0)
+	{
+		Interpolation.Bezier.InTangentX = 0.0;
+		Interpolation.Bezier.InTangentY = 0.0;
+		Interpolation.Bezier.OutTangentX = 0.0;
+		Interpolation.Bezier.OutTangentY = 0.0;
+	}
+
+	// Constructor for Linear interpolation
+	AnimationKeyframe(double value)
+	    : Id(s_NextId++)
+	    , Value(value)
+	{
+		Interpolation.Bezier.InTangentX = 0.0;
+		Interpolation.Bezier.InTangentY = 0.0;
+		Interpolation.Bezier.OutTangentX = 0.0;
+		Interpolation.Bezier.OutTangentY = 0.0;
+	}
+
+	// Constructor for Bezier interpolation
+	AnimationKeyframe(double value, double inTangentX, double inTangentY, double outTangentX, double outTangentY)
+	    : Id(s_NextId++)
+	    , Value(value)
+	{
+		Interpolation.Bezier.InTangentX = inTangentX;
+		Interpolation.Bezier.InTangentY = inTangentY;
+		Interpolation.Bezier.OutTangentX = outTangentX;
+		Interpolation.Bezier.OutTangentY = outTangentY;
+	}
+
+	// Constructor for TCB interpolation
+	AnimationKeyframe(double value, double tension, double continuity, double bias)
+	    : Id(s_NextId++)
+	    , Value(value)
+	{
+		Interpolation.Bezier.OutTangentY = 0.0;
+		Interpolation.TCB.Tension = tension;
+		Interpolation.TCB.Continuity = continuity;
+		Interpolation.TCB.Bias = bias;
+	}
+
+	// Constructor for Ease In/Out interpolation
+	AnimationKeyframe(double value, double easeIn, double easeOut)
+	    : Id(s_NextId++)
+	    , Value(value)
+	{
+		Interpolation.Bezier.OutTangentX = 0.0;
+		Interpolation.Bezier.OutTangentY = 0.0;
+		Interpolation.EaseInOut.EaseIn = easeIn;
+		Interpolation.EaseInOut.EaseOut = easeOut;
+	}
+
+private:
+	friend AnimationTrack;
+	friend AnimationVectorTrack;
+	friend AnimationRotationTrack;
+	// Atomic ID generator
+	static std::atomic<ptrdiff_t> s_NextId;
+
+}; /* class AnimationKeyframe */
+
+#endif /* ANIMATION_KEYFRAME__H */
+
+/* end of file */
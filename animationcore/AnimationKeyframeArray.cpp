@@ -0,0 +1,456 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationKeyframeArray.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+static_assert(sizeof(AnimationKeyframe::InterpolationData) == AnimationKeyframeArray::ParameterCount * sizeof(double),
+    "Interpolation parameter slots must match the keyframe interpolation data");
+
+// Round a value to the storage type of a column
+template <typename T>
+static inline T storedValue(double value)
+{
+	return static_cast<T>(value);
+}
+
+template <>
+inline qfloat16 storedValue<qfloat16>(double value)
+{
+	return qfloat16(static_cast<float>(value));
+}
+
+template <typename T>
+static void rotateElement(QVector<T> &array, int from, int to)
+{
+	// Move a single element, shifting only the elements in between
+	T *data = array.data();
+	if (from < to)
+		std::rotate(data + from, data + from + 1, data + to + 1);
+	else if (to < from)
+		std::rotate(data + to, data + from, data + from + 1);
+}
+
+AnimationKeyframeArray::Column::Column()
+    : m_Precision(Precision::Double)
+{
+}
+
+void AnimationKeyframeArray::Column::setPrecision(Precision precision)
+{
+	if (m_Precision == precision)
+		return;
+
+	Column res;
+	res.m_Precision = precision;
+	res.append(*this, 0, size());
+	*this = res;
+}
+
+int AnimationKeyframeArray::Column::size() const
+{
+	int res = 0;
+	visit([&](const auto &data) { res = data.size(); });
+	return res;
+}
+
+template <>
+const QVector<double> &AnimationKeyframeArray::Column::array<double>() const
+{
+	return m_Double;
+}
+
+template <>
+const QVector<float> &AnimationKeyframeArray::Column::array<float>() const
+{
+	return m_Float;
+}
+
+template <>
+const QVector<qfloat16> &AnimationKeyframeArray::Column::array<qfloat16>() const
+{
+	return m_Half;
+}
+
+void AnimationKeyframeArray::Column::reserve(int size)
+{
+	visit([&](auto &data) { data.reserve(size); });
+}
+
+void AnimationKeyframeArray::Column::clear()
+{
+	visit([&](auto &data) { data.clear(); });
+}
+
+void AnimationKeyframeArray::Column::insert(int index, double value)
+{
+	visit([&](auto &data) { data.insert(index, storedValue<typename std::decay_t<decltype(data)>::value_type>(value)); });
+}
+
+void AnimationKeyframeArray::Column::append(double value)
+{
+	visit([&](auto &data) { data.append(storedValue<typename std::decay_t<decltype(data)>::value_type>(value)); });
+}
+
+void AnimationKeyframeArray::Column::append(const Column &column, int from, int to)
+{
+	if (from >= to)
+		return;
+	if (column.m_Precision == m_Precision)
+	{
+		// Copy as a block
+		visit([&](auto &data) {
+			const auto &source = column.array<typename std::decay_t<decltype(data)>::value_type>();
+			int index = data.size();
+			data.resize(index + to - from);
+			std::copy(source.constData() + from, source.constData() + to, data.data() + index);
+		});
+		return;
+	}
+
+	// Round every element to this precision
+	visit([&](auto &data) {
+		typedef typename std::decay_t<decltype(data)>::value_type T;
+		int index = data.size();
+		data.resize(index + to - from);
+		T *out = data.data() + index;
+		for (int i = from; i < to; ++i)
+			*out++ = storedValue<T>(column.at(i));
+	});
+}
+
+void AnimationKeyframeArray::Column::remove(int index)
+{
+	visit([&](auto &data) { data.remove(index); });
+}
+
+void AnimationKeyframeArray::Column::rotate(int from, int to)
+{
+	visit([&](auto &data) { rotateElement(data, from, to); });
+}
+
+bool AnimationKeyframeArray::Column::equals(const Column &other) const
+{
+	if (m_Precision == other.m_Precision)
+	{
+		switch (m_Precision)
+		{
+		case Precision::Float:
+			return m_Float == other.m_Float;
+		case Precision::Half:
+			return m_Half.size() == other.m_Half.size() && memcmp(m_Half.constData(), other.m_Half.constData(), m_Half.size() * sizeof(qfloat16)) == 0;
+		default:
+			return m_Double == other.m_Double;
+		}
+	}
+
+	// Compare the values as read back
+	if (size() != other.size())
+		return false;
+	for (int i = 0; i < size(); ++i)
+	{
+		if (at(i) != other.at(i))
+			return false;
+	}
+	return true;
+}
+
+size_t AnimationKeyframeArray::Column::memoryUsage() const
+{
+	size_t res = 0;
+	visit([&](const auto &data) { res = data.capacity() * sizeof(typename std::decay_t<decltype(data)>::value_type); });
+	return res;
+}
+
+AnimationKeyframeArray::AnimationKeyframeArray()
+{
+}
+
+void AnimationKeyframeArray::setPrecision(Precision precision)
+{
+	m_Values.setPrecision(precision);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].setPrecision(precision);
+}
+
+AnimationKeyframeArray AnimationKeyframeArray::fromMap(const QMap<double, AnimationKeyframe> &keyframes)
+{
+	// The map is already sorted, so this can append directly
+	AnimationKeyframeArray res;
+	res.reserve(keyframes.size());
+	for (QMap<double, AnimationKeyframe>::const_iterator it = keyframes.constBegin(); it != keyframes.constEnd(); ++it)
+	{
+		double parameters[ParameterCount];
+		memcpy(parameters, &it.value().Interpolation, sizeof(parameters));
+		res.m_Times.append(it.key());
+		res.m_Values.append(it.value().Value);
+		res.m_Ids.append(it.value().Id);
+		for (int slot = 0; slot < ParameterCount; ++slot)
+			res.m_Parameters[slot].append(parameters[slot]);
+	}
+	return res;
+}
+
+QMap<double, AnimationKeyframe> AnimationKeyframeArray::toMap() const
+{
+	QMap<double, AnimationKeyframe> res;
+	for (int i = 0; i < m_Times.size(); ++i)
+	{
+		// Insert at the end, since the times are sorted
+		res.insert(res.constEnd(), m_Times[i], keyframe(i));
+	}
+	return res;
+}
+
+void AnimationKeyframeArray::reserve(int size)
+{
+	m_Times.reserve(size);
+	m_Values.reserve(size);
+	m_Ids.reserve(size);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].reserve(size);
+}
+
+void AnimationKeyframeArray::clear()
+{
+	m_Times.clear();
+	m_Values.clear();
+	m_Ids.clear();
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].clear();
+}
+
+AnimationKeyframe AnimationKeyframeArray::keyframe(int index) const
+{
+	AnimationKeyframe res;
+	res.Id = m_Ids[index];
+	res.Value = m_Values.at(index);
+	double parameters[ParameterCount];
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		parameters[slot] = m_Parameters[slot].at(index);
+	memcpy(&res.Interpolation, parameters, sizeof(parameters));
+	return res;
+}
+
+void AnimationKeyframeArray::setKeyframe(int index, const AnimationKeyframe &keyframe)
+{
+	double parameters[ParameterCount];
+	memcpy(parameters, &keyframe.Interpolation, sizeof(parameters));
+	m_Ids[index] = keyframe.Id;
+	m_Values.set(index, keyframe.Value);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].set(index, parameters[slot]);
+}
+
+int AnimationKeyframeArray::lowerBound(double time) const
+{
+	return static_cast<int>(std::lower_bound(m_Times.constBegin(), m_Times.constEnd(), time) - m_Times.constBegin());
+}
+
+int AnimationKeyframeArray::upperBound(double time) const
+{
+	return static_cast<int>(std::upper_bound(m_Times.constBegin(), m_Times.constEnd(), time) - m_Times.constBegin());
+}
+
+int AnimationKeyframeArray::indexOf(double time) const
+{
+	int index = lowerBound(time);
+	if (index < m_Times.size() && m_Times[index] == time)
+		return index;
+	return -1;
+}
+
+int AnimationKeyframeArray::insert(double time, const AnimationKeyframe &keyframe)
+{
+	int index = lowerBound(time);
+	if (index == m_Times.size() || m_Times[index] != time)
+	{
+		// Make room for the new keyframe
+		m_Times.insert(index, time);
+		m_Values.insert(index, 0.0);
+		m_Ids.insert(index, -1);
+		for (int slot = 0; slot < ParameterCount; ++slot)
+			m_Parameters[slot].insert(index, 0.0);
+	}
+	setKeyframe(index, keyframe);
+	return index;
+}
+
+void AnimationKeyframeArray::append(double time, const AnimationKeyframe &keyframe)
+{
+	double parameters[ParameterCount];
+	memcpy(parameters, &keyframe.Interpolation, sizeof(parameters));
+	m_Times.append(time);
+	m_Values.append(keyframe.Value);
+	m_Ids.append(keyframe.Id);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].append(parameters[slot]);
+}
+
+void AnimationKeyframeArray::remove(int index)
+{
+	m_Times.remove(index);
+	m_Values.remove(index);
+	m_Ids.remove(index);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].remove(index);
+}
+
+int AnimationKeyframeArray::move(int index, double toTime)
+{
+	// Remove any other keyframe that is already at the destination time
+	int existing = indexOf(toTime);
+	if (existing == index)
+		return index;
+	if (existing != -1)
+	{
+		remove(existing);
+		if (existing < index)
+			--index;
+	}
+
+	// Destination index after taking the keyframe out of the array
+	int to = lowerBound(toTime);
+	if (to > index)
+		--to;
+
+	// Rotate the keyframe into place
+	m_Times[index] = toTime;
+	rotateElement(m_Times, index, to);
+	m_Values.rotate(index, to);
+	rotateElement(m_Ids, index, to);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].rotate(index, to);
+	return to;
+}
+
+void AnimationKeyframeArray::append(const AnimationKeyframeArray &keyframes, int from, int to)
+{
+	// Copy a run of keyframes to the end, one block per array
+	if (from >= to)
+		return;
+	int index = m_Times.size();
+	m_Times.resize(index + to - from);
+	m_Ids.resize(index + to - from);
+	std::copy(keyframes.m_Times.constData() + from, keyframes.m_Times.constData() + to, m_Times.data() + index);
+	std::copy(keyframes.m_Ids.constData() + from, keyframes.m_Ids.constData() + to, m_Ids.data() + index);
+	m_Values.append(keyframes.m_Values, from, to);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		m_Parameters[slot].append(keyframes.m_Parameters[slot], from, to);
+}
+
+void AnimationKeyframeArray::merge(const AnimationKeyframeArray &keyframes)
+{
+	if (keyframes.isEmpty())
+		return;
+	if (isEmpty())
+	{
+		Precision keep = precision();
+		*this = keyframes;
+		setPrecision(keep);
+		return;
+	}
+
+	// Alternate between runs of existing and merged keyframes, the runs are copied as blocks
+	AnimationKeyframeArray res;
+	res.setPrecision(precision());
+	res.reserve(size() + keyframes.size());
+	const double *times = m_Times.constData();
+	const double *mergedTimes = keyframes.m_Times.constData();
+	int i = 0;
+	int j = 0;
+	while (j < keyframes.size())
+	{
+		// Existing keyframes before the next merged one, dropping the one it replaces
+		int next = static_cast<int>(std::lower_bound(times + i, times + size(), mergedTimes[j]) - times);
+		res.append(*this, i, next);
+		i = (next < size() && times[next] == mergedTimes[j]) ? next + 1 : next;
+
+		// Merged keyframes before the next existing one
+		int nextMerged = i < size()
+		    ? static_cast<int>(std::lower_bound(mergedTimes + j, mergedTimes + keyframes.size(), times[i]) - mergedTimes)
+		    : keyframes.size();
+		res.append(keyframes, j, nextMerged);
+		j = nextMerged;
+	}
+	res.append(*this, i, size());
+	*this = res;
+}
+
+bool AnimationKeyframeArray::equals(const AnimationKeyframeArray &other, AnimationInterpolation interpolationMethod) const
+{
+	if (m_Times != other.m_Times || !m_Values.equals(other.m_Values) || m_Ids != other.m_Ids)
+	{
+		return false;
+	}
+
+	int parameterCount;
+	switch (interpolationMethod)
+	{
+	case AnimationInterpolation::Bezier:
+		parameterCount = 4;
+		break;
+	case AnimationInterpolation::TCB:
+		parameterCount = 3;
+		break;
+	case AnimationInterpolation::EaseInOut:
+		parameterCount = 2;
+		break;
+	default:
+		parameterCount = 0;
+		break;
+	}
+
+	for (int slot = 0; slot < parameterCount; ++slot)
+	{
+		if (!m_Parameters[slot].equals(other.m_Parameters[slot]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t AnimationKeyframeArray::memoryUsage() const
+{
+	size_t res = m_Times.capacity() * sizeof(double);
+	res += m_Values.memoryUsage();
+	res += m_Ids.capacity() * sizeof(ptrdiff_t);
+	for (int slot = 0; slot < ParameterCount; ++slot)
+		res += m_Parameters[slot].memoryUsage();
+	return res;
+}
+
+/* end of file */
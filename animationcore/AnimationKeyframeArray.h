@@ -0,0 +1,253 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationKeyframeArray stores the keyframes of a track as sorted contiguous
+arrays, one for the times, the values, the identifiers, and each of the
+interpolation parameters. Linear scans and evaluation touch only the arrays
+they need, and there is no allocation per keyframe.
+
+The interpolation parameter slots overlay the same way as the union in
+AnimationKeyframe::InterpolationData, so their meaning depends on the
+interpolation method of the track.
+
+The values and interpolation parameters can be stored in single or half
+precision, to keep long and dense tracks resident in less memory. They are
+rounded when written and read back as double. Times and identifiers are
+always stored in full, since keyframes are looked up by exact time.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_KEYFRAME_ARRAY__H
+#define ANIMATION_KEYFRAME_ARRAY__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QVector>
+#include <QMap>
+#include <QFloat16>
+
+#include "AnimationKeyframe.h"
+
+class ANIMATIONCORE_EXPORT AnimationKeyframeArray
+{
+public:
+	// Interpolation parameter slots, matching the layout of AnimationKeyframe::InterpolationData
+	enum ParameterSlot
+	{
+		InTangentX = 0,
+		InTangentY = 1,
+		OutTangentX = 2,
+		OutTangentY = 3,
+		Tension = 0,
+		Continuity = 1,
+		Bias = 2,
+		EaseIn = 0,
+		EaseOut = 1,
+		ParameterCount = 4,
+	};
+
+	// Storage of the values and interpolation parameters
+	enum class Precision
+	{
+		Double,
+		Float,
+		Half, // About three significant digits, within +/-65504
+	};
+
+	AnimationKeyframeArray();
+
+	// Conversion from and to the map representation
+	static AnimationKeyframeArray fromMap(const QMap<double, AnimationKeyframe> &keyframes);
+	QMap<double, AnimationKeyframe> toMap() const;
+
+	// Size
+	int size() const { return m_Times.size(); }
+	bool isEmpty() const { return m_Times.isEmpty(); }
+	void reserve(int size);
+	void clear();
+
+	// Precision, changing it rounds the stored values and parameters
+	Precision precision() const { return m_Values.precision(); }
+	void setPrecision(Precision precision);
+
+	// Contiguous arrays
+	// The values and parameters are only available as arrays with Double precision, these return null otherwise
+	const double *times() const { return m_Times.constData(); }
+	const double *values() const { return m_Values.data(); }
+	const ptrdiff_t *ids() const { return m_Ids.constData(); }
+	const double *parameters(int slot) const { return m_Parameters[slot].data(); }
+	double *values() { return m_Values.data(); }
+	double *parameters(int slot) { return m_Parameters[slot].data(); }
+
+	// Element access
+	double time(int index) const { return m_Times[index]; }
+	double value(int index) const { return m_Values.at(index); }
+	ptrdiff_t id(int index) const { return m_Ids[index]; }
+	double parameter(int slot, int index) const { return m_Parameters[slot].at(index); }
+	AnimationKeyframe keyframe(int index) const;
+	void setKeyframe(int index, const AnimationKeyframe &keyframe);
+	void setId(int index, ptrdiff_t id) { m_Ids[index] = id; }
+	void setValue(int index, double value) { m_Values.set(index, value); }
+	void setParameter(int slot, int index, double value) { m_Parameters[slot].set(index, value); }
+
+	// Search, these return an index in the range [0, size()]
+	int lowerBound(double time) const;
+	int upperBound(double time) const;
+	int indexOf(double time) const; // Exact match, or -1
+
+	// Modification, keeping the times sorted and unique
+	int insert(double time, const AnimationKeyframe &keyframe); // Replaces any keyframe at the same time
+	void append(double time, const AnimationKeyframe &keyframe); // Time must be after the last keyframe
+	void remove(int index);
+	int move(int index, double toTime); // Replaces any other keyframe at the destination time
+	void merge(const AnimationKeyframeArray &keyframes); // Linear merge, replaces any keyframes at the same times, keeps the precision
+
+	// Equality, only comparing the parameters that are used by the interpolation method
+	bool equals(const AnimationKeyframeArray &other, AnimationInterpolation interpolationMethod) const;
+
+	// Approximate heap memory used by the arrays
+	size_t memoryUsage() const;
+
+private:
+	// Values or parameters of all keyframes, only the array of the current precision is used
+	class Column
+	{
+	public:
+		Column();
+
+		Precision precision() const { return m_Precision; }
+		void setPrecision(Precision precision);
+
+		inline double at(int index) const
+		{
+			switch (m_Precision)
+			{
+			case Precision::Float:
+				return m_Float[index];
+			case Precision::Half:
+				return static_cast<float>(m_Half[index]);
+			default:
+				return m_Double[index];
+			}
+		}
+
+		inline void set(int index, double value)
+		{
+			switch (m_Precision)
+			{
+			case Precision::Float:
+				m_Float[index] = static_cast<float>(value);
+				break;
+			case Precision::Half:
+				m_Half[index] = qfloat16(static_cast<float>(value));
+				break;
+			default:
+				m_Double[index] = value;
+				break;
+			}
+		}
+
+		double *data() { return m_Precision == Precision::Double ? m_Double.data() : nullptr; }
+		const double *data() const { return m_Precision == Precision::Double ? m_Double.constData() : nullptr; }
+
+		int size() const;
+		void reserve(int size);
+		void clear();
+		void insert(int index, double value);
+		void append(double value);
+		void append(const Column &column, int from, int to);
+		void remove(int index);
+		void rotate(int from, int to);
+		bool equals(const Column &other) const;
+		size_t memoryUsage() const;
+
+	private:
+		// Array of the precision that matches T
+		template <typename T>
+		const QVector<T> &array() const;
+
+		// Call function with the array of the current precision
+		template <typename Function>
+		inline void visit(Function &&function)
+		{
+			switch (m_Precision)
+			{
+			case Precision::Float:
+				function(m_Float);
+				break;
+			case Precision::Half:
+				function(m_Half);
+				break;
+			default:
+				function(m_Double);
+				break;
+			}
+		}
+
+		template <typename Function>
+		inline void visit(Function &&function) const
+		{
+			switch (m_Precision)
+			{
+			case Precision::Float:
+				function(m_Float);
+				break;
+			case Precision::Half:
+				function(m_Half);
+				break;
+			default:
+				function(m_Double);
+				break;
+			}
+		}
+
+		Precision m_Precision;
+		QVector<double> m_Double;
+		QVector<float> m_Float;
+		QVector<qfloat16> m_Half;
+
+	};
+
+	void append(const AnimationKeyframeArray &keyframes, int from, int to);
+
+	QVector<double> m_Times;
+	Column m_Values;
+	QVector<ptrdiff_t> m_Ids;
+	Column m_Parameters[ParameterCount];
+
+}; /* class AnimationKeyframeArray */
+
+#endif /* ANIMATION_KEYFRAME_ARRAY__H */
+
+/* end of file */
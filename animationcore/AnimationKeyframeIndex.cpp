@@ -0,0 +1,94 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationKeyframeIndex.h"
+
+#include "AnimationTrack.h"
+
+AnimationKeyframeIndex::AnimationKeyframeIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+int AnimationKeyframeIndex::size() const
+{
+	return m_Locations.size();
+}
+
+bool AnimationKeyframeIndex::contains(ptrdiff_t id) const
+{
+	return m_Locations.contains(id);
+}
+
+AnimationKeyframeIndex::Location AnimationKeyframeIndex::location(ptrdiff_t id) const
+{
+	return m_Locations.value(id, Location { nullptr, 0.0 });
+}
+
+AnimationTrack *AnimationKeyframeIndex::track(ptrdiff_t id) const
+{
+	return location(id).Track;
+}
+
+int AnimationKeyframeIndex::position(ptrdiff_t id) const
+{
+	Location location = this->location(id);
+	return location.Track ? location.Track->keyframeArray().indexOf(location.Time) : -1;
+}
+
+void AnimationKeyframeIndex::trackAttached(AnimationTrack *track)
+{
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	m_Locations.reserve(m_Locations.size() + keyframes.size());
+	for (int i = 0; i < keyframes.size(); ++i)
+		m_Locations.insert(keyframes.id(i), Location { track, keyframes.time(i) });
+}
+
+void AnimationKeyframeIndex::trackDetached(AnimationTrack *track)
+{
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	for (int i = 0; i < keyframes.size(); ++i)
+		keyframeRemoved(track, keyframes.id(i));
+}
+
+void AnimationKeyframeIndex::keyframeRemoved(AnimationTrack *track, ptrdiff_t id)
+{
+	// Leave the entry alone if the ID has since been taken by another track
+	if (m_Locations.value(id).Track == track)
+		m_Locations.remove(id);
+}
+
+void AnimationKeyframeIndex::keyframeInserted(AnimationTrack *track, double time, ptrdiff_t id)
+{
+	m_Locations.insert(id, Location { track, time });
+}
+
+/* end of file */
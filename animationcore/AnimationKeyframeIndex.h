@@ -0,0 +1,95 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationKeyframeIndex maps the ID of every keyframe on its tracks to the
+track that holds it and its time, so that a selection of keyframe IDs can
+be resolved without scanning the tracks. Tracks attached with
+AnimationTrack::setKeyframeIndex keep the index up to date as they are
+edited.
+
+The position of a keyframe in its track shifts whenever a keyframe before
+it is inserted or removed, so the index stores the time, from which the
+position is found with a binary search. Keyframe IDs are expected to be
+unique across the tracks of an index.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_KEYFRAME_INDEX__H
+#define ANIMATION_KEYFRAME_INDEX__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QObject>
+#include <QHash>
+
+#include "AnimationKeyframe.h"
+
+class AnimationTrack;
+
+class ANIMATIONCORE_EXPORT AnimationKeyframeIndex : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit AnimationKeyframeIndex(QObject *parent = nullptr);
+
+	struct Location
+	{
+		AnimationTrack *Track; // Null when the ID is not in the index
+		double Time;
+	};
+
+	// Lookup
+	int size() const;
+	bool contains(ptrdiff_t id) const;
+	Location location(ptrdiff_t id) const;
+	AnimationTrack *track(ptrdiff_t id) const;
+	int position(ptrdiff_t id) const; // Position in the keyframe array of the track, or -1
+
+private:
+	friend AnimationTrack;
+
+	// Called by the tracks
+	void trackAttached(AnimationTrack *track);
+	void trackDetached(AnimationTrack *track);
+	void keyframeRemoved(AnimationTrack *track, ptrdiff_t id);
+	void keyframeInserted(AnimationTrack *track, double time, ptrdiff_t id);
+
+	QHash<ptrdiff_t, Location> m_Locations;
+
+}; /* class AnimationKeyframeIndex */
+
+#endif /* ANIMATION_KEYFRAME_INDEX__H */
+
+/* end of file */
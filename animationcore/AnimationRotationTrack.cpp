@@ -0,0 +1,630 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationRotationTrack.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "AnimationEvaluator.h"
+#include "AnimationTrack.h"
+
+namespace /* anonymous */ {
+
+// Taylor series of sin(x) / x in x * x, accurate to double precision up to x == pi
+const int SincTerms = 12;
+const double SincCoefficients[SincTerms] = {
+	1.0,
+	-1.0 / 6.0,
+	1.0 / 120.0,
+	-1.0 / 5040.0,
+	1.0 / 362880.0,
+	-1.0 / 39916800.0,
+	1.0 / 6227020800.0,
+	-1.0 / 1307674368000.0,
+	1.0 / 355687428096000.0,
+	-1.0 / 121645100408832000.0,
+	1.0 / 51090942171709440000.0,
+	-1.0 / 25852016738884976640000.0,
+};
+
+// Keeps the weights finite between opposite quaternions, where the arc is undefined
+const double MinSinc = 1e-12;
+
+template <typename Lanes>
+inline typename Lanes::Vector sinc(typename Lanes::Vector x)
+{
+	typename Lanes::Vector y = Lanes::mul(x, x);
+	typename Lanes::Vector res = Lanes::set(SincCoefficients[SincTerms - 1]);
+	for (int k = SincTerms - 2; k >= 0; --k)
+		res = Lanes::add(Lanes::set(SincCoefficients[k]), Lanes::mul(y, res));
+	return res;
+}
+
+inline double dot(const double *a, const double *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+void normalize(double *q)
+{
+	double length = std::sqrt(dot(q, q));
+	if (length > 0.0)
+	{
+		for (int c = 0; c < 4; ++c)
+			q[c] /= length;
+	}
+	else
+	{
+		q[0] = q[1] = q[2] = 0.0;
+		q[3] = 1.0;
+	}
+}
+
+void multiply(const double *a, const double *b, double *out)
+{
+	double x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+	double y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+	double z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+	double w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+	out[3] = w;
+}
+
+// Logarithm of a unit quaternion, the rotation axis scaled by half the rotation angle
+void logarithm(const double *q, double *out)
+{
+	double s = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+	double scale = s > 0.0 ? std::atan2(s, q[3]) / s : 1.0;
+	for (int c = 0; c < 3; ++c)
+		out[c] = q[c] * scale;
+}
+
+void exponential(const double *v, double *out)
+{
+	double angle = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	double scale = sinc<AnimationScalarLanes<double>>(angle);
+	for (int c = 0; c < 3; ++c)
+		out[c] = v[c] * scale;
+	out[3] = std::cos(angle);
+}
+
+// Arc between two unit quaternions, from the chord lengths, which stays accurate for nearby quaternions
+void arc(const double *a, const double *b, double *angle, double *invSinc)
+{
+	double difference = 0.0;
+	double sum = 0.0;
+	for (int c = 0; c < 4; ++c)
+	{
+		difference += (a[c] - b[c]) * (a[c] - b[c]);
+		sum += (a[c] + b[c]) * (a[c] + b[c]);
+	}
+	*angle = 2.0 * std::atan2(std::sqrt(difference), std::sqrt(sum));
+	*invSinc = 1.0 / std::max(sinc<AnimationScalarLanes<double>>(*angle), MinSinc);
+}
+
+// Slerp of the lanes at index, from a to b, with the arc of every lane given, and normalize the result
+// The components are stored as separate arrays, so the lanes are consecutive samples
+template <typename Lanes>
+inline void slerp(int index, const double *u, const double *angle, const double *invSinc, const double *const *a, const double *const *b, double *const *out)
+{
+	typedef typename Lanes::Vector Vector;
+	const Vector one = Lanes::set(1.0);
+	Vector uu = Lanes::load(u + index);
+	Vector vv = Lanes::sub(one, uu);
+	Vector aa = Lanes::load(angle + index);
+	Vector inv = Lanes::load(invSinc + index);
+	Vector w0 = Lanes::mul(Lanes::mul(vv, sinc<Lanes>(Lanes::mul(vv, aa))), inv);
+	Vector w1 = Lanes::mul(Lanes::mul(uu, sinc<Lanes>(Lanes::mul(uu, aa))), inv);
+
+	Vector q[4];
+	Vector length = Lanes::set(0.0);
+	for (int c = 0; c < 4; ++c)
+	{
+		q[c] = Lanes::add(Lanes::mul(w0, Lanes::load(a[c] + index)), Lanes::mul(w1, Lanes::load(b[c] + index)));
+		length = Lanes::add(length, Lanes::mul(q[c], q[c]));
+	}
+	Vector scale = Lanes::div(one, Lanes::sqrt(length));
+	for (int c = 0; c < 4; ++c)
+		Lanes::store(out[c] + index, Lanes::mul(q[c], scale));
+}
+
+void slerp(int count, const double *u, const double *angle, const double *invSinc, const double *const *a, const double *const *b, double *const *out)
+{
+	typedef AnimationEvaluatorLanes<double> Lanes;
+	int i = 0;
+	for (; i + Lanes::Width <= count; i += Lanes::Width)
+		slerp<Lanes>(i, u, angle, invSinc, a, b, out);
+	for (; i < count; ++i)
+		slerp<AnimationScalarLanes<double>>(i, u, angle, invSinc, a, b, out);
+}
+
+} /* anonymous namespace */
+
+// Gathers the samples of one interpolation method, and evaluates them together when full or flushed
+class AnimationRotationTrack::Batch
+{
+public:
+	explicit Batch(Interpolation interpolation)
+	    : m_Interpolation(interpolation)
+	    , m_Count(0)
+	{
+	}
+
+	void add(const Segment &segment, double time, double *out)
+	{
+		int i = m_Count;
+		m_Out[i] = out;
+		m_U[i] = (time - segment.Time) * segment.InvDuration;
+		m_Angle[i] = segment.Angle;
+		m_InvSinc[i] = segment.InvSinc;
+		for (int c = 0; c < 4; ++c)
+		{
+			m_Q0[c][i] = segment.Q0[c];
+			m_Q1[c][i] = segment.Q1[c];
+		}
+		if (m_Interpolation == Interpolation::Squad)
+		{
+			m_ControlAngle[i] = segment.ControlAngle;
+			m_ControlInvSinc[i] = segment.ControlInvSinc;
+			for (int c = 0; c < 4; ++c)
+			{
+				m_A0[c][i] = segment.A0[c];
+				m_A1[c][i] = segment.A1[c];
+			}
+		}
+		if (++m_Count == Capacity)
+			flush();
+	}
+
+	void flush()
+	{
+		int count = m_Count;
+		if (!count)
+			return;
+
+		double *q0[4] = { m_Q0[0], m_Q0[1], m_Q0[2], m_Q0[3] };
+		double *q1[4] = { m_Q1[0], m_Q1[1], m_Q1[2], m_Q1[3] };
+		if (m_Interpolation == Interpolation::Squad)
+		{
+			// Slerp between the keyframes and between the control points, into the keyframe and control arrays
+			double *a0[4] = { m_A0[0], m_A0[1], m_A0[2], m_A0[3] };
+			double *a1[4] = { m_A1[0], m_A1[1], m_A1[2], m_A1[3] };
+			slerp(count, m_U, m_Angle, m_InvSinc, q0, q1, q0);
+			slerp(count, m_U, m_ControlAngle, m_ControlInvSinc, a0, a1, a0);
+
+			// Then slerp from the first to the second by 2u(1 - u), the arc between them differs for every sample
+			for (int i = 0; i < count; ++i)
+			{
+				double p[4] = { m_Q0[0][i], m_Q0[1][i], m_Q0[2][i], m_Q0[3][i] };
+				double s[4] = { m_A0[0][i], m_A0[1][i], m_A0[2][i], m_A0[3][i] };
+				arc(p, s, &m_Angle[i], &m_InvSinc[i]);
+				m_U[i] = 2.0 * m_U[i] * (1.0 - m_U[i]);
+			}
+			slerp(count, m_U, m_Angle, m_InvSinc, q0, a0, q1);
+		}
+		else
+		{
+			slerp(count, m_U, m_Angle, m_InvSinc, q0, q1, q1);
+		}
+
+		// The result is in the second keyframe array
+		for (int i = 0; i < count; ++i)
+		{
+			for (int c = 0; c < 4; ++c)
+				m_Out[i][c] = m_Q1[c][i];
+		}
+		m_Count = 0;
+	}
+
+private:
+	static const int Capacity = 32;
+
+	Interpolation m_Interpolation;
+	int m_Count;
+	double *m_Out[Capacity];
+
+	// One array per component, lane i of every array belongs to the same sample
+	double m_U[Capacity];
+	double m_Angle[Capacity];
+	double m_InvSinc[Capacity];
+	double m_Q0[4][Capacity];
+	double m_Q1[4][Capacity];
+	double m_ControlAngle[Capacity];
+	double m_ControlInvSinc[Capacity];
+	double m_A0[4][Capacity];
+	double m_A1[4][Capacity];
+
+}; /* class AnimationRotationTrack::Batch */
+
+AnimationRotationTrack::AnimationRotationTrack()
+    : m_Interpolation(Interpolation::Slerp)
+    , m_SegmentCursor(-1)
+{
+}
+
+void AnimationRotationTrack::quaternionFromEuler(const double *angles, double *quaternion)
+{
+	double cx = std::cos(angles[0] * 0.5), sx = std::sin(angles[0] * 0.5);
+	double cy = std::cos(angles[1] * 0.5), sy = std::sin(angles[1] * 0.5);
+	double cz = std::cos(angles[2] * 0.5), sz = std::sin(angles[2] * 0.5);
+	quaternion[0] = sx * cy * cz - cx * sy * sz;
+	quaternion[1] = cx * sy * cz + sx * cy * sz;
+	quaternion[2] = cx * cy * sz - sx * sy * cz;
+	quaternion[3] = cx * cy * cz + sx * sy * sz;
+}
+
+AnimationRotationTrack AnimationRotationTrack::fromEulerTracks(const AnimationTrack *const *tracks)
+{
+	AnimationRotationTrack res;
+
+	// Union of the keyframe times of the three angles
+	QVector<double> times;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const AnimationKeyframeArray &keyframes = tracks[axis]->keyframeArray();
+		for (int i = 0; i < keyframes.size(); ++i)
+			times.append(keyframes.time(i));
+	}
+	std::sort(times.begin(), times.end());
+	times.erase(std::unique(times.begin(), times.end()), times.end());
+
+	// The times are sorted, so every keyframe is appended
+	res.reserve(times.size());
+	for (double time : times)
+	{
+		double angles[3];
+		double quaternion[4];
+		for (int axis = 0; axis < 3; ++axis)
+			angles[axis] = tracks[axis]->valueAtTime(time);
+		quaternionFromEuler(angles, quaternion);
+		res.insert(time, AnimationKeyframe::s_NextId++, quaternion);
+	}
+	return res;
+}
+
+int AnimationRotationTrack::indexOf(double time) const
+{
+	int index = static_cast<int>(std::lower_bound(m_Times.constBegin(), m_Times.constEnd(), time) - m_Times.constBegin());
+	if (index < m_Times.size() && m_Times[index] == time)
+		return index;
+	return -1;
+}
+
+void AnimationRotationTrack::setInterpolation(Interpolation interpolation)
+{
+	if (m_Interpolation != interpolation)
+	{
+		m_Interpolation = interpolation;
+		invalidateAllSegments();
+	}
+}
+
+void AnimationRotationTrack::reserve(int size)
+{
+	m_Times.reserve(size);
+	m_Ids.reserve(size);
+	m_Rotations.reserve(size * 4);
+}
+
+void AnimationRotationTrack::clear()
+{
+	m_Times.clear();
+	m_Ids.clear();
+	m_Rotations.clear();
+	invalidateAllSegments();
+}
+
+int AnimationRotationTrack::upsertKeyframe(double time, const double *quaternion)
+{
+	return insert(time, AnimationKeyframe::s_NextId++, quaternion);
+}
+
+void AnimationRotationTrack::setRotation(int index, const double *quaternion)
+{
+	setQuaternion(index, quaternion);
+
+	// The Squad control points of the neighbours depend on this keyframe
+	invalidateSegments(index - 2, index + 2);
+}
+
+void AnimationRotationTrack::removeKeyframe(double time)
+{
+	int index = indexOf(time);
+	if (index == -1)
+		return;
+
+	m_Times.remove(index);
+	m_Ids.remove(index);
+	m_Rotations.remove(index * 4, 4);
+	keyframeRemoved(index);
+}
+
+int AnimationRotationTrack::moveKeyframe(double fromTime, double toTime)
+{
+	int index = indexOf(fromTime);
+	if (index == -1 || fromTime == toTime)
+		return index;
+
+	// Take the keyframe out and insert it again, keeping its ID
+	double quaternion[4];
+	std::copy(rotation(index), rotation(index) + 4, quaternion);
+	ptrdiff_t id = m_Ids[index];
+	removeKeyframe(fromTime);
+	return insert(toTime, id, quaternion);
+}
+
+int AnimationRotationTrack::insert(double time, ptrdiff_t id, const double *quaternion)
+{
+	int index = static_cast<int>(std::lower_bound(m_Times.constBegin(), m_Times.constEnd(), time) - m_Times.constBegin());
+	if (index == m_Times.size() || m_Times[index] != time)
+	{
+		// Make room for the new keyframe
+		m_Times.insert(index, time);
+		m_Ids.insert(index, id);
+		m_Rotations.insert(index * 4, 4, 0.0);
+		keyframeInserted(index);
+	}
+	else
+	{
+		m_Ids[index] = id;
+		invalidateSegments(index - 2, index + 2);
+	}
+	setQuaternion(index, quaternion);
+	return index;
+}
+
+void AnimationRotationTrack::setQuaternion(int index, const double *quaternion)
+{
+	double *q = m_Rotations.data() + index * 4;
+	std::copy(quaternion, quaternion + 4, q);
+	normalize(q);
+}
+
+void AnimationRotationTrack::valueAtTime(double time, double *out) const
+{
+	int size = m_Times.size();
+	if (size == 0)
+	{
+		static const double identity[4] = { 0.0, 0.0, 0.0, 1.0 };
+		std::copy(identity, identity + 4, out);
+		return;
+	}
+	if (time <= m_Times[0])
+	{
+		std::copy(rotation(0), rotation(0) + 4, out);
+		return;
+	}
+	if (time >= m_Times[size - 1])
+	{
+		std::copy(rotation(size - 1), rotation(size - 1) + 4, out);
+		return;
+	}
+
+	updateSegments();
+	int index = animationSegmentAt(m_Times.constData(), size, time, m_SegmentCursor);
+	m_SegmentCursor = index;
+	Batch batch(m_Interpolation);
+	batch.add(m_Segments[index], time, out);
+	batch.flush();
+}
+
+void AnimationRotationTrack::sampleRange(double fromTime, double timeStep, size_t count, double *out) const
+{
+	if (timeStep < 0.0 && count > 1)
+	{
+		// Walk the segments forward and reverse the samples
+		sampleRange(fromTime + timeStep * (count - 1), -timeStep, count, out);
+		for (size_t i = 0, j = count - 1; i < j; ++i, --j)
+			std::swap_ranges(out + i * 4, out + (i + 1) * 4, out + j * 4);
+		return;
+	}
+
+	int size = m_Times.size();
+	if (size == 0)
+	{
+		for (size_t i = 0; i < count; ++i)
+			valueAtTime(0.0, out + i * 4);
+		return;
+	}
+
+	updateSegments();
+	const double *times = m_Times.constData();
+
+	// Samples before the first keyframe
+	size_t i = 0;
+	for (; i < count && fromTime + i * timeStep <= times[0]; ++i)
+		std::copy(rotation(0), rotation(0) + 4, out + i * 4);
+
+	// Consecutive samples fill the lanes of a batch, across segment boundaries
+	if (i < count)
+	{
+		Batch batch(m_Interpolation);
+		int index = animationSegmentAt(times, size, fromTime + i * timeStep, -1);
+		while (i < count && index < size - 1)
+		{
+			double time1 = times[index + 1];
+			for (; i < count && fromTime + i * timeStep < time1; ++i)
+				batch.add(m_Segments[index], fromTime + i * timeStep, out + i * 4);
+
+			// Skip ahead with a search when there are many keyframes between two samples
+			double nextTime = fromTime + i * timeStep;
+			if (i < count && index + 2 < size && nextTime >= times[index + 2])
+				index = static_cast<int>(std::upper_bound(times, times + size, nextTime) - times) - 1;
+			else
+				++index;
+		}
+		batch.flush();
+	}
+
+	// Samples after the last keyframe
+	for (; i < count; ++i)
+		std::copy(rotation(size - 1), rotation(size - 1) + 4, out + i * 4);
+}
+
+void AnimationRotationTrack::evaluateTracks(const AnimationRotationTrack *const *tracks, int count, double time, double *out)
+{
+	// Joints within their keyframes go to the batch of their interpolation method, the others are written directly
+	Batch slerpBatch(Interpolation::Slerp);
+	Batch squadBatch(Interpolation::Squad);
+	for (int i = 0; i < count; ++i)
+	{
+		const AnimationRotationTrack *track = tracks[i];
+		int size = track->m_Times.size();
+		if (size == 0 || time <= track->m_Times[0] || time >= track->m_Times[size - 1])
+		{
+			track->valueAtTime(time, out + i * 4);
+			continue;
+		}
+		track->updateSegments();
+		int index = animationSegmentAt(track->m_Times.constData(), size, time, track->m_SegmentCursor);
+		track->m_SegmentCursor = index;
+		Batch &batch = track->m_Interpolation == Interpolation::Squad ? squadBatch : slerpBatch;
+		batch.add(track->m_Segments[index], time, out + i * 4);
+	}
+	slerpBatch.flush();
+	squadBatch.flush();
+}
+
+void AnimationRotationTrack::controlPoint(int index, double *out) const
+{
+	// The ends have no neighbour on one side, and use the keyframe itself
+	const double *q = rotation(index);
+	if (index == 0 || index == m_Times.size() - 1)
+	{
+		std::copy(q, q + 4, out);
+		return;
+	}
+
+	// q * exp(-(log(q^-1 * next) + log(q^-1 * previous)) / 4), with the neighbours in the hemisphere of q
+	double inverse[4] = { -q[0], -q[1], -q[2], q[3] };
+	double tangent[3] = { 0.0, 0.0, 0.0 };
+	for (int neighbour = index - 1; neighbour <= index + 1; neighbour += 2)
+	{
+		double relative[4];
+		double log[3];
+		multiply(inverse, rotation(neighbour), relative);
+		if (relative[3] < 0.0)
+		{
+			for (int c = 0; c < 4; ++c)
+				relative[c] = -relative[c];
+		}
+		logarithm(relative, log);
+		for (int c = 0; c < 3; ++c)
+			tangent[c] -= log[c] * 0.25;
+	}
+	double offset[4];
+	exponential(tangent, offset);
+	multiply(q, offset, out);
+	normalize(out);
+}
+
+void AnimationRotationTrack::updateSegments() const
+{
+	if (!m_DirtySegments.isDirty())
+		return;
+
+	const double *times = m_Times.constData();
+	for (int i = m_DirtySegments.From; i < m_DirtySegments.To; ++i)
+	{
+		Segment &segment = m_Segments[i];
+		segment.Time = times[i];
+		segment.InvDuration = 1.0 / (times[i + 1] - times[i]);
+
+		// Take the shortest arc, q and -q are the same rotation
+		const double *q0 = rotation(i);
+		const double *q1 = rotation(i + 1);
+		double sign = dot(q0, q1) < 0.0 ? -1.0 : 1.0;
+		for (int c = 0; c < 4; ++c)
+		{
+			segment.Q0[c] = q0[c];
+			segment.Q1[c] = q1[c] * sign;
+		}
+		arc(segment.Q0, segment.Q1, &segment.Angle, &segment.InvSinc);
+
+		if (m_Interpolation == Interpolation::Squad)
+		{
+			// The control point flips along with its keyframe
+			controlPoint(i, segment.A0);
+			controlPoint(i + 1, segment.A1);
+			for (int c = 0; c < 4; ++c)
+				segment.A1[c] *= sign;
+			arc(segment.A0, segment.A1, &segment.ControlAngle, &segment.ControlInvSinc);
+		}
+	}
+	m_DirtySegments.clear();
+}
+
+void AnimationRotationTrack::invalidateSegments(int from, int to) const
+{
+	m_DirtySegments.invalidate(from, to, m_Segments.size());
+}
+
+void AnimationRotationTrack::invalidateAllSegments() const
+{
+	int count = std::max(static_cast<int>(m_Times.size()) - 1, 0);
+	m_Segments.resize(count);
+	m_DirtySegments.invalidateAll(count);
+}
+
+void AnimationRotationTrack::keyframeInserted(int index) const
+{
+	// Squad also changes the control points of both neighbours
+	int neighbours = m_Interpolation == Interpolation::Squad ? 2 : 1;
+	int first = m_DirtySegments.keyframesInserted(index, index, 1, m_Times.size(), m_Segments.size(), neighbours, [&](int segment, int added) {
+		m_Segments.insert(segment, added, Segment());
+	});
+	if (first < 0)
+		invalidateAllSegments();
+}
+
+void AnimationRotationTrack::keyframeRemoved(int index) const
+{
+	int neighbours = m_Interpolation == Interpolation::Squad ? 2 : 1;
+	int first = m_DirtySegments.keyframeRemoved(index, m_Times.size(), m_Segments.size(), neighbours, [&](int segment) {
+		m_Segments.remove(segment);
+	});
+	if (first < 0)
+		invalidateAllSegments();
+}
+
+size_t AnimationRotationTrack::memoryUsage() const
+{
+	size_t res = m_Times.capacity() * sizeof(double);
+	res += m_Ids.capacity() * sizeof(ptrdiff_t);
+	res += m_Rotations.capacity() * sizeof(double);
+	res += m_Segments.capacity() * sizeof(Segment);
+	return res;
+}
+
+/* end of file */
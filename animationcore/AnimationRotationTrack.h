@@ -0,0 +1,164 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationRotationTrack animates an orientation as a unit quaternion, stored
+as x, y, z and w, rather than as three Euler angle tracks. Keyframes are
+normalized when they are set, and every segment takes the shortest arc
+between its two keyframes, whatever the signs of the stored quaternions.
+
+Slerp interpolates at constant angular speed along the arc between two
+keyframes. Squad adds inner control points computed from the neighbouring
+keyframes, which makes the angular velocity continuous across keyframes.
+
+Evaluation gathers the samples into batches and evaluates a batch with the
+vector registers, several samples or joints at a time. The slerp weights use
+sin(u * a) / sin(a) == u * sinc(u * a) / sinc(a), with sinc as a polynomial,
+so the lanes need no trigonometric calls beyond those of the cached segments.
+As with AnimationTrack, the segments are rebuilt by the first evaluation
+after an edit, so evaluation is not safe to call concurrently with edits.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_ROTATION_TRACK__H
+#define ANIMATION_ROTATION_TRACK__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QVector>
+
+#include "AnimationKeyframe.h"
+#include "AnimationSegmentCache.h"
+
+class AnimationTrack;
+
+class ANIMATIONCORE_EXPORT AnimationRotationTrack
+{
+public:
+	enum class Interpolation
+	{
+		Slerp,
+		Squad
+	};
+
+	AnimationRotationTrack();
+
+	// Quaternion of Euler angles in radians, rotating about the X axis first, then Y, then Z, all fixed axes
+	static void quaternionFromEuler(const double *angles, double *quaternion);
+
+	// Convert three Euler angle tracks, for X, Y and Z, into keyframes at the union of their keyframe times
+	// Interpolating between the converted keyframes follows the shortest arc, not the path of the angle curves
+	static AnimationRotationTrack fromEulerTracks(const AnimationTrack *const *tracks);
+
+	// Getters
+	int size() const { return m_Times.size(); }
+	bool isEmpty() const { return m_Times.isEmpty(); }
+	Interpolation interpolation() const { return m_Interpolation; }
+	const double *times() const { return m_Times.constData(); }
+	double time(int index) const { return m_Times[index]; }
+	ptrdiff_t id(int index) const { return m_Ids[index]; }
+	const double *rotation(int index) const { return m_Rotations.constData() + index * 4; } // Normalized x, y, z, w
+	int indexOf(double time) const; // Exact match, or -1
+
+	// Setters
+	void setInterpolation(Interpolation interpolation);
+	void reserve(int size);
+	void clear();
+
+	// Keyframe manipulation, the quaternions are normalized, and a zero quaternion becomes the identity
+	// The upsert function assigns a new ID, and replaces any keyframe at the same time, returning its index
+	int upsertKeyframe(double time, const double *quaternion);
+	void setRotation(int index, const double *quaternion);
+	void removeKeyframe(double time);
+	int moveKeyframe(double fromTime, double toTime); // Replaces any other keyframe at the destination time
+
+	// Evaluation, writing a normalized quaternion for every sample, clamped to the first and last keyframe
+	// The single time version also caches the last segment it located for the next call
+	void valueAtTime(double time, double *out) const;
+	void sampleRange(double fromTime, double timeStep, size_t count, double *out) const;
+
+	// Evaluate many tracks, such as the joints of a skeleton, at one time, writing four values per track
+	// Runs on the calling thread, and updates the cached segment of every track like valueAtTime
+	static void evaluateTracks(const AnimationRotationTrack *const *tracks, int count, double time, double *out);
+
+	// Approximate heap memory used, including the cached segments
+	size_t memoryUsage() const;
+
+private:
+	class Batch;
+
+	int insert(double time, ptrdiff_t id, const double *quaternion);
+	void setQuaternion(int index, const double *quaternion);
+
+	Interpolation m_Interpolation;
+
+	// Keyframe i holds m_Rotations[i * 4] to m_Rotations[i * 4 + 3]
+	QVector<double> m_Times;
+	QVector<ptrdiff_t> m_Ids;
+	QVector<double> m_Rotations;
+
+	// Cached segment between keyframes i and i + 1, with the end quaternion flipped into the hemisphere of the start
+	// Angle is the arc between the quaternions, and InvSinc the reciprocal of sinc(Angle), likewise for the control points
+	struct Segment
+	{
+		double Time;
+		double InvDuration;
+		double Q0[4];
+		double Q1[4];
+		double Angle;
+		double InvSinc;
+		double A0[4]; // Squad only
+		double A1[4];
+		double ControlAngle;
+		double ControlInvSinc;
+	};
+
+	// Segments in the dirty range are rebuilt on the next evaluation
+	mutable QVector<Segment> m_Segments;
+	mutable AnimationSegmentCacheRange m_DirtySegments;
+
+	// Index of the last segment evaluated by valueAtTime, validated against the keyframe times on use
+	mutable int m_SegmentCursor;
+
+	void updateSegments() const;
+	void invalidateSegments(int from, int to) const;
+	void invalidateAllSegments() const;
+	void keyframeInserted(int index) const;
+	void keyframeRemoved(int index) const;
+	void controlPoint(int index, double *out) const;
+
+}; /* class AnimationRotationTrack */
+
+#endif /* ANIMATION_ROTATION_TRACK__H */
+
+/* end of file */
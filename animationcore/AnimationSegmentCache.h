@@ -0,0 +1,156 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationSegmentCacheRange tracks which cached segments of a track must be
+rebuilt before the next evaluation, segment i spanning keyframes i and i + 1.
+It shifts the pending range as keyframes are inserted or removed, and tells
+the track where to insert or remove the entries of its own per-segment arrays.
+Interpolation methods that look further than the keyframes of a segment pass
+a wider neighbourhood, squad rotations reach two keyframes on either side.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_SEGMENT_CACHE__H
+#define ANIMATION_SEGMENT_CACHE__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <algorithm>
+
+struct AnimationSegmentCacheRange
+{
+	// Segments From up to To are rebuilt on the next evaluation
+	int From = 0;
+	int To = 0;
+
+	bool isDirty() const
+	{
+		return From < To;
+	}
+
+	void clear()
+	{
+		From = 0;
+		To = 0;
+	}
+
+	// Mark segments from up to to, out of count, merged with the pending range
+	void invalidate(int from, int to, int count)
+	{
+		from = std::max(from, 0);
+		to = std::min(to, count);
+		if (from >= to)
+			return;
+
+		// A gap between two edits is rebuilt along with them
+		if (From < To)
+		{
+			from = std::min(from, From);
+			to = std::max(to, To);
+		}
+		From = from;
+		To = to;
+	}
+
+	void invalidateAll(int count)
+	{
+		From = 0;
+		To = count;
+	}
+
+	// Keyframes from to to were inserted or replaced, inserted of them are new, and the track now has keyframeCount
+	// keyframes and segmentCount cached segments. Calls insert(segment, added) to grow the per-segment arrays, and marks
+	// the changed segments with the given number of neighbours on either side. Returns the first changed segment,
+	// or -1 when the cache was out of step with the keyframes and must be rebuilt entirely
+	template <typename Insert>
+	int keyframesInserted(int from, int to, int inserted, int keyframeCount, int segmentCount, int neighbours, const Insert &insert)
+	{
+		// An inserted keyframe splits a segment in two, or extends the track by one segment at either end
+		int count = std::max(keyframeCount - 1, 0);
+		if (segmentCount != std::max(keyframeCount - inserted - 1, 0))
+			return -1;
+		if (count > segmentCount)
+		{
+			int segment = std::min(from, segmentCount);
+			int added = count - segmentCount;
+			insert(segment, added);
+			if (To > segment)
+				To += added;
+			if (From > segment)
+				From += added;
+		}
+		invalidate(from - neighbours, to + neighbours, count);
+		return std::max(from - neighbours, 0);
+	}
+
+	// The keyframe at index was removed, same as keyframesInserted, calls remove(segment) to shrink the per-segment arrays
+	template <typename Remove>
+	int keyframeRemoved(int index, int keyframeCount, int segmentCount, int neighbours, const Remove &remove)
+	{
+		// The segments on both sides of the removed keyframe merge into one
+		int count = std::max(keyframeCount - 1, 0);
+		if (segmentCount != (keyframeCount == 0 ? 0 : count + 1))
+			return -1;
+		if (count < segmentCount)
+		{
+			int segment = std::min(index, count);
+			remove(segment);
+			if (To > segment)
+				--To;
+			if (From > segment)
+				--From;
+		}
+		invalidate(index - neighbours, index + neighbours - 1, count);
+		return std::max(index - neighbours, 0);
+	}
+
+}; /* class AnimationSegmentCacheRange */
+
+// Segment containing the time, which must be within the keyframe times
+// Checks the hint and its successor before falling back to a binary search
+inline int animationSegmentAt(const double *times, int size, double time, int hint)
+{
+	if (hint >= 0 && hint + 1 < size && time >= times[hint])
+	{
+		if (time < times[hint + 1])
+			return hint;
+		if (hint + 2 < size && time < times[hint + 2])
+			return hint + 1;
+	}
+	return static_cast<int>(std::upper_bound(times, times + size, time) - times) - 1;
+}
+
+#endif /* ANIMATION_SEGMENT_CACHE__H */
+
+/* end of file */
@@ -0,0 +1,1329 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationTrack.h"
+#include "AnimationTrackSnapshot.h"
+#include "AnimationUndoJournal.h"
+#include "AnimationKeyframeIndex.h"
+
+#include <QRandomGenerator>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace /* anonymous */ {
+
+// Call function(begin, end) over chunks of [0, count), on the calling thread and on the global thread pool
+// The calling thread takes part, so this also completes when the pool is busy
+template <typename Function>
+void runChunks(int count, int chunkSize, const Function &function)
+{
+	int chunkCount = (count + chunkSize - 1) / chunkSize;
+	QThreadPool *pool = QThreadPool::globalInstance();
+	int helperCount = std::min(chunkCount, pool->maxThreadCount()) - 1;
+
+	std::atomic<int> nextChunk(0);
+	auto runNextChunks = [&]() {
+		int chunk;
+		while ((chunk = nextChunk++) < chunkCount)
+			function(chunk * chunkSize, std::min((chunk + 1) * chunkSize, count));
+	};
+
+	// Helpers that start late find no chunks left and return immediately
+	QSemaphore done;
+	int started = 0;
+	for (int i = 0; i < helperCount; ++i)
+	{
+		if (!pool->tryStart([&]() {
+			    runNextChunks();
+			    done.release();
+		    }))
+			break;
+		++started;
+	}
+	runNextChunks();
+	done.acquire(started);
+}
+
+// Conversions of the interpolation parameters of the keyframes in a set of lanes, p[slot] holds a parameter slot
+// Every method converts to and from Bezier handles, the conversion between two others goes through the handles in registers
+struct KeepParameters
+{
+	template <typename Lanes>
+	static void apply(typename Lanes::Vector *) { }
+};
+
+struct DefaultToBezier
+{
+	// Linear tangents as a reasonable default
+	template <typename Lanes>
+	static void apply(typename Lanes::Vector *p)
+	{
+		p[AnimationKeyframeArray::InTangentX] = Lanes::set(1.0);
+		p[AnimationKeyframeArray::InTangentY] = Lanes::set(0.0);
+		p[AnimationKeyframeArray::OutTangentX] = Lanes::set(1.0);
+		p[AnimationKeyframeArray::OutTangentY] = Lanes::set(0.0);
+	}
+};
+
+struct TCBToBezier
+{
+	// Modify these heuristics as needed to better match the desired conversion
+	template <typename Lanes>
+	static void apply(typename Lanes::Vector *p)
+	{
+		typename Lanes::Vector tangentX = Lanes::div(Lanes::set(1.0), Lanes::add(Lanes::set(1.0), p[0]));
+		typename Lanes::Vector bias = p[2];
+		p[0] = tangentX;
+		p[1] = Lanes::mul(bias, tangentX);
+		p[2] = tangentX;
+		p[3] = Lanes::mul(Lanes::mul(Lanes::set(-1.0), bias), tangentX);
+	}
+};
+
+struct EaseInOutToBezier
+{
+	template <typename Lanes>
+	static void apply(typename Lanes::Vector *p)
+	{
+		typename Lanes::Vector easeIn = p[0];
+		typename Lanes::Vector easeOut = p[1];
+		p[0] = Lanes::set(1.0);
+		p[1] = easeIn;
+		p[2] = Lanes::set(1.0);
+		p[3] = easeOut;
+	}
+};
+
+struct BezierToTCB
+{
+	// Modify these heuristics as needed to better match the desired conversion, continuity starts at 0.0
+	template <typename Lanes>
+	static void apply(typename Lanes::Vector *p)
+	{
+		typename Lanes::Vector absY = Lanes::add(Lanes::abs(p[1]), Lanes::abs(p[3]));
+		typename Lanes::Vector absX = Lanes::add(Lanes::abs(p[0]), Lanes::abs(p[2]));
+		typename Lanes::Vector tension = Lanes::sub(Lanes::set(1.0), Lanes::div(absY, absX));
+		typename Lanes::Vector bias = Lanes::div(Lanes::sub(p[1], p[3]), absY);
+		p[0] = tension;
+		p[1] = Lanes::set(0.0);
+		p[2] = bias;
+	}
+};
+
+struct BezierToEaseInOut
+{
+	template <typename Lanes>
+	static void apply(typename Lanes::Vector *p)
+	{
+		typename Lanes::Vector easeIn = Lanes::abs(Lanes::div(p[1], p[0]));
+		typename Lanes::Vector easeOut = Lanes::abs(Lanes::div(p[3], p[2]));
+		p[0] = easeIn;
+		p[1] = easeOut;
+	}
+};
+
+template <typename ToBezier, typename FromBezier, typename Lanes>
+inline void convertLanes(double *const *columns, int index)
+{
+	typename Lanes::Vector p[AnimationKeyframeArray::ParameterCount];
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		p[slot] = Lanes::load(columns[slot] + index);
+	ToBezier::template apply<Lanes>(p);
+	FromBezier::template apply<Lanes>(p);
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		Lanes::store(columns[slot] + index, p[slot]);
+}
+
+// One pass over the parameter columns, which must be in double precision
+template <typename ToBezier, typename FromBezier>
+void convertParameters(AnimationKeyframeArray &keyframes)
+{
+	double *columns[AnimationKeyframeArray::ParameterCount];
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		columns[slot] = keyframes.parameters(slot);
+
+	typedef AnimationEvaluatorLanes<double> Lanes;
+	int count = keyframes.size();
+	int i = 0;
+	for (; i + Lanes::Width <= count; i += Lanes::Width)
+		convertLanes<ToBezier, FromBezier, Lanes>(columns, i);
+	for (; i < count; ++i)
+		convertLanes<ToBezier, FromBezier, AnimationScalarLanes<double>>(columns, i);
+}
+
+template <typename ToBezier>
+void convertParameters(AnimationKeyframeArray &keyframes, AnimationInterpolation to)
+{
+	switch (to)
+	{
+	case AnimationInterpolation::TCB:
+		convertParameters<ToBezier, BezierToTCB>(keyframes);
+		break;
+	case AnimationInterpolation::EaseInOut:
+		convertParameters<ToBezier, BezierToEaseInOut>(keyframes);
+		break;
+	default:
+		convertParameters<ToBezier, KeepParameters>(keyframes);
+		break;
+	}
+}
+
+// Grow the value range to contain the extremes of a cubic segment between its ends
+void expandSegmentRange(const AnimationCurveSegment<double> &segment, double &minValue, double &maxValue)
+{
+	// Roots of C1 + 2 C2 u + 3 C3 u^2 within the segment
+	double a = 3.0 * segment.C3;
+	double b = 2.0 * segment.C2;
+	double c = segment.C1;
+	double roots[2];
+	int rootCount = 0;
+	if (std::abs(a) < 1e-12)
+	{
+		if (b != 0.0)
+			roots[rootCount++] = -c / b;
+	}
+	else
+	{
+		double discriminant = b * b - 4.0 * a * c;
+		if (discriminant >= 0.0)
+		{
+			double sqrtDiscriminant = std::sqrt(discriminant);
+			roots[rootCount++] = (-b - sqrtDiscriminant) / (2.0 * a);
+			roots[rootCount++] = (-b + sqrtDiscriminant) / (2.0 * a);
+		}
+	}
+	for (int j = 0; j < rootCount; ++j)
+	{
+		double u = roots[j];
+		if (u > 0.0 && u < 1.0)
+		{
+			double value = segment.C0 + u * (segment.C1 + u * (segment.C2 + u * segment.C3));
+			minValue = std::min(minValue, value);
+			maxValue = std::max(maxValue, value);
+		}
+	}
+}
+
+} /* anonymous namespace */
+
+// Initialize the atomic ID generator
+std::atomic<ptrdiff_t> AnimationKeyframe::s_NextId(0);
+
+AnimationTrack::AnimationTrack(QObject *parent)
+    : QObject(parent)
+    , m_Keyframes()
+    , m_InterpolationMethod(AnimationInterpolation::Linear)
+    , m_TreeWidgetItem(nullptr)
+    , m_Name(QStringLiteral("Track"))
+    , m_Color(0xFFFFFFFF)
+    , m_KeyframeMapValid(false)
+    , m_SegmentCursor(-1)
+    , m_CurveVersion(0)
+    , m_DirtyValueRangesFrom(0)
+    , m_BezierInverseTables(true)
+    , m_SnapshotVersion(0)
+    , m_SnapshotStale(false)
+    , m_SnapshotScheduled(false)
+    , m_EditDepth(0)
+    , m_EditChangePending(false)
+    , m_EditFromTime(0.0)
+    , m_EditToTime(0.0)
+    , m_EditMinValue(0.0)
+    , m_EditMaxValue(0.0)
+{
+	publishSnapshot();
+}
+
+AnimationTrack::~AnimationTrack()
+{
+	if (m_KeyframeIndex)
+		m_KeyframeIndex->trackDetached(this);
+}
+
+const AnimationKeyframeArray &AnimationTrack::keyframeArray() const
+{
+	return m_Keyframes;
+}
+
+const QMap<double, AnimationKeyframe> &AnimationTrack::keyframes() const
+{
+	if (!m_KeyframeMapValid)
+	{
+		m_KeyframeMap = m_Keyframes.toMap();
+		m_KeyframeMapValid = true;
+	}
+	return m_KeyframeMap;
+}
+
+void AnimationTrack::invalidateKeyframeMap() const
+{
+	if (m_KeyframeMapValid)
+	{
+		m_KeyframeMap.clear();
+		m_KeyframeMapValid = false;
+	}
+}
+
+void AnimationTrack::invalidateKeyframes() const
+{
+	invalidateKeyframeMap();
+	invalidateAllSegments();
+}
+
+AnimationInterpolation AnimationTrack::interpolationMethod() const
+{
+	return m_InterpolationMethod;
+}
+
+void AnimationTrack::setKeyframes(const AnimationKeyframeArray &keyframes)
+{
+	// This uses existing keyframes to preserve their IDs
+	if (!m_Keyframes.equals(keyframes, m_InterpolationMethod))
+		replaceKeyframes(keyframes);
+}
+
+void AnimationTrack::replaceKeyframes(const AnimationKeyframeArray &keyframes)
+{
+	if (reportsKeyframes())
+	{
+		for (int i = 0; i < m_Keyframes.size(); ++i)
+			reportKeyframeRemoved(m_Keyframes.time(i), m_Keyframes.keyframe(i));
+	}
+
+	// The track keeps its own precision
+	double minValue = std::numeric_limits<double>::infinity();
+	double maxValue = -std::numeric_limits<double>::infinity();
+	expandValueRange(0, m_Keyframes.size() - 1, minValue, maxValue);
+	AnimationKeyframeArray::Precision precision = m_Keyframes.precision();
+	m_Keyframes = keyframes;
+	m_Keyframes.setPrecision(precision);
+	invalidateKeyframes();
+
+	if (reportsKeyframes())
+	{
+		for (int i = 0; i < m_Keyframes.size(); ++i)
+			reportKeyframeInserted(m_Keyframes.time(i), m_Keyframes.keyframe(i));
+	}
+	expandValueRange(0, m_Keyframes.size() - 1, minValue, maxValue);
+	keyframesEdited(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), minValue, maxValue);
+}
+
+void AnimationTrack::setKeyframes(const QMap<double, AnimationKeyframe> &keyframes)
+{
+	setKeyframes(AnimationKeyframeArray::fromMap(keyframes));
+}
+
+void AnimationTrack::setInterpolationMethod(AnimationInterpolation interpolationMethod)
+{
+	if (AnimationUndoJournal *journal = recordingJournal())
+		journal->interpolationMethodChanged(this, m_InterpolationMethod, interpolationMethod);
+
+	m_InterpolationMethod = interpolationMethod;
+	invalidateAllSegments();
+	invalidateSnapshot();
+	emit interpolationMethodChanged();
+}
+
+void AnimationTrack::setKeyframes(const AnimationKeyframeArray &keyframes, AnimationInterpolation interpolationMethod)
+{
+	EditScope scope(this);
+	replaceKeyframes(keyframes);
+	if (m_InterpolationMethod != interpolationMethod)
+		setInterpolationMethod(interpolationMethod);
+}
+
+void AnimationTrack::convertInterpolationMethod(AnimationInterpolation interpolationMethod)
+{
+	if (m_InterpolationMethod == interpolationMethod)
+		return;
+
+	AnimationKeyframeArray keyframes = m_Keyframes;
+	convertInterpolation(keyframes, m_InterpolationMethod, interpolationMethod);
+	setKeyframes(keyframes, interpolationMethod);
+}
+
+void AnimationTrack::upsertKeyframe(double time, const AnimationKeyframe &keyframe)
+{
+	// Assign a unique ID to the keyframe
+	AnimationKeyframe newKeyframe = keyframe;
+	newKeyframe.Id = AnimationKeyframe::s_NextId++;
+	insertKeyframe(time, newKeyframe);
+}
+
+void AnimationTrack::insertKeyframe(double time, const AnimationKeyframe &keyframe)
+{
+	if (reportsKeyframes())
+	{
+		int index = m_Keyframes.indexOf(time);
+		if (index != -1)
+			reportKeyframeRemoved(time, m_Keyframes.keyframe(index));
+	}
+
+	double minValue = std::numeric_limits<double>::infinity();
+	double maxValue = -std::numeric_limits<double>::infinity();
+	expandValueRange(m_Keyframes.lowerBound(time) - 1, m_Keyframes.upperBound(time), minValue, maxValue);
+	int size = m_Keyframes.size();
+	int index = m_Keyframes.insert(time, keyframe);
+	if (reportsKeyframes())
+		reportKeyframeInserted(time, m_Keyframes.keyframe(index)); // As stored, in the precision of the track
+	if (m_Keyframes.size() != size)
+		keyframeInserted(index);
+	else
+		invalidateSegments(index - 1, index + 1);
+	expandValueRange(index - 1, index + 1, minValue, maxValue);
+	keyframesEdited(index - 1, index + 1, minValue, maxValue);
+}
+
+void AnimationTrack::upsertKeyframes(const QVector<QPair<double, AnimationKeyframe>> &keyframes)
+{
+	if (keyframes.isEmpty())
+		return;
+
+	// Sort once, stable so that the last of several keyframes at the same time wins, as with upsertKeyframe
+	// Recorded and generated keyframes usually arrive in order already
+	QVector<int> order(keyframes.size());
+	std::iota(order.begin(), order.end(), 0);
+	auto earlier = [&keyframes](int a, int b) { return keyframes[a].first < keyframes[b].first; };
+	if (!std::is_sorted(order.begin(), order.end(), earlier))
+		std::stable_sort(order.begin(), order.end(), earlier);
+	AnimationKeyframeArray batch;
+	batch.setPrecision(m_Keyframes.precision());
+	batch.reserve(keyframes.size());
+	for (int i : order)
+	{
+		if (!batch.isEmpty() && batch.time(batch.size() - 1) == keyframes[i].first)
+			batch.setKeyframe(batch.size() - 1, keyframes[i].second);
+		else
+			batch.append(keyframes[i].first, keyframes[i].second);
+	}
+
+	// Assign unique IDs to the keyframes as one contiguous block
+	ptrdiff_t id = AnimationKeyframe::s_NextId.fetch_add(batch.size());
+	for (int i = 0; i < batch.size(); ++i)
+		batch.setId(i, id + i);
+
+	if (reportsKeyframes())
+	{
+		for (int i = 0; i < batch.size(); ++i)
+		{
+			int index = m_Keyframes.indexOf(batch.time(i));
+			if (index != -1)
+				reportKeyframeRemoved(batch.time(i), m_Keyframes.keyframe(index));
+			reportKeyframeInserted(batch.time(i), batch.keyframe(i));
+		}
+	}
+
+	double minValue = std::numeric_limits<double>::infinity();
+	double maxValue = -std::numeric_limits<double>::infinity();
+	expandValueRange(m_Keyframes.lowerBound(batch.time(0)) - 1, m_Keyframes.upperBound(batch.time(batch.size() - 1)), minValue, maxValue);
+	int size = m_Keyframes.size();
+	m_Keyframes.merge(batch);
+	int from = m_Keyframes.indexOf(batch.time(0));
+	int to = m_Keyframes.indexOf(batch.time(batch.size() - 1));
+	keyframesMerged(from, to, m_Keyframes.size() - size);
+	expandValueRange(from - 1, to + 1, minValue, maxValue);
+	keyframesEdited(from - 1, to + 1, minValue, maxValue);
+}
+
+void AnimationTrack::removeKeyframe(double time)
+{
+	int index = m_Keyframes.indexOf(time);
+	if (index != -1)
+	{
+		if (reportsKeyframes())
+			reportKeyframeRemoved(time, m_Keyframes.keyframe(index));
+
+		double minValue = std::numeric_limits<double>::infinity();
+		double maxValue = -std::numeric_limits<double>::infinity();
+		expandValueRange(index - 1, index + 1, minValue, maxValue);
+		m_Keyframes.remove(index);
+		keyframeRemoved(index);
+		expandValueRange(index - 1, index, minValue, maxValue);
+		keyframesEdited(index - 1, index, minValue, maxValue);
+	}
+}
+
+void AnimationTrack::moveKeyframe(double fromTime, double toTime)
+{
+	int index = m_Keyframes.indexOf(fromTime);
+	if (index != -1)
+	{
+		if (reportsKeyframes())
+		{
+			int replaced = m_Keyframes.indexOf(toTime);
+			if (replaced != -1 && replaced != index)
+				reportKeyframeRemoved(toTime, m_Keyframes.keyframe(replaced));
+			AnimationKeyframe keyframe = m_Keyframes.keyframe(index);
+			reportKeyframeRemoved(fromTime, keyframe);
+			reportKeyframeInserted(toTime, keyframe);
+		}
+
+		double minValue = std::numeric_limits<double>::infinity();
+		double maxValue = -std::numeric_limits<double>::infinity();
+		expandValueRange(std::min(index, m_Keyframes.lowerBound(toTime)) - 1, std::max(index + 1, m_Keyframes.upperBound(toTime)), minValue, maxValue);
+		int size = m_Keyframes.size();
+		int toIndex = m_Keyframes.move(index, toTime);
+
+		// Every segment between the old and the new position changes, moving onto
+		// another keyframe replaces it, which leaves one segment less
+		int from = std::min(index, toIndex);
+		int to = std::max(index, toIndex);
+		if (m_Keyframes.size() != size)
+			keyframeRemoved(from);
+		invalidateSegments(from - 1, to + 1);
+		expandValueRange(from - 1, to + 1, minValue, maxValue);
+		keyframesEdited(from - 1, to + 1, minValue, maxValue);
+	}
+}
+
+void AnimationTrack::beginEdit()
+{
+	++m_EditDepth;
+}
+
+void AnimationTrack::endEdit()
+{
+	Q_ASSERT(m_EditDepth > 0);
+	if (--m_EditDepth > 0)
+		return;
+
+	if (m_SnapshotStale)
+		scheduleSnapshot();
+	if (m_EditChangePending)
+	{
+		m_EditChangePending = false;
+		emit keyframesChanged();
+		emit keyframesRangeChanged(m_EditFromTime, m_EditToTime, m_EditMinValue, m_EditMaxValue);
+	}
+}
+
+bool AnimationTrack::isEditing() const
+{
+	return m_EditDepth > 0;
+}
+
+void AnimationTrack::setUndoJournal(AnimationUndoJournal *journal)
+{
+	if (m_UndoJournal == journal)
+		return;
+
+	if (m_UndoJournal)
+		m_UndoJournal->trackDetached(this);
+	m_UndoJournal = journal;
+	if (m_UndoJournal)
+		m_UndoJournal->trackAttached(this);
+}
+
+AnimationUndoJournal *AnimationTrack::undoJournal() const
+{
+	return m_UndoJournal;
+}
+
+AnimationUndoJournal *AnimationTrack::recordingJournal() const
+{
+	AnimationUndoJournal *journal = m_UndoJournal;
+	return journal && journal->isRecording() ? journal : nullptr;
+}
+
+void AnimationTrack::setKeyframeIndex(AnimationKeyframeIndex *index)
+{
+	if (m_KeyframeIndex == index)
+		return;
+
+	if (m_KeyframeIndex)
+		m_KeyframeIndex->trackDetached(this);
+	m_KeyframeIndex = index;
+	if (m_KeyframeIndex)
+		m_KeyframeIndex->trackAttached(this);
+}
+
+AnimationKeyframeIndex *AnimationTrack::keyframeIndex() const
+{
+	return m_KeyframeIndex;
+}
+
+bool AnimationTrack::reportsKeyframes() const
+{
+	return m_KeyframeIndex || recordingJournal();
+}
+
+void AnimationTrack::reportKeyframeRemoved(double time, const AnimationKeyframe &keyframe)
+{
+	if (AnimationUndoJournal *journal = recordingJournal())
+		journal->keyframeRemoved(this, time, keyframe);
+	if (m_KeyframeIndex)
+		m_KeyframeIndex->keyframeRemoved(this, keyframe.Id);
+}
+
+void AnimationTrack::reportKeyframeInserted(double time, const AnimationKeyframe &keyframe)
+{
+	if (AnimationUndoJournal *journal = recordingJournal())
+		journal->keyframeInserted(this, time, keyframe);
+	if (m_KeyframeIndex)
+		m_KeyframeIndex->keyframeInserted(this, time, keyframe.Id);
+}
+
+void AnimationTrack::keyframesEdited(int from, int to, double minValue, double maxValue)
+{
+	// The curve only depends on the keyframes at both ends of each segment
+	const double *times = m_Keyframes.times();
+	double fromTime = from >= 0 ? times[from] : -std::numeric_limits<double>::infinity();
+	double toTime = to < m_Keyframes.size() ? times[to] : std::numeric_limits<double>::infinity();
+	keyframesEdited(fromTime, toTime, minValue, maxValue);
+}
+
+void AnimationTrack::keyframesEdited(double fromTime, double toTime, double minValue, double maxValue)
+{
+	invalidateKeyframeMap();
+	invalidateSnapshot();
+	if (m_EditDepth > 0)
+	{
+		if (m_EditChangePending)
+		{
+			m_EditFromTime = std::min(m_EditFromTime, fromTime);
+			m_EditToTime = std::max(m_EditToTime, toTime);
+			m_EditMinValue = std::min(m_EditMinValue, minValue);
+			m_EditMaxValue = std::max(m_EditMaxValue, maxValue);
+		}
+		else
+		{
+			m_EditFromTime = fromTime;
+			m_EditToTime = toTime;
+			m_EditMinValue = minValue;
+			m_EditMaxValue = maxValue;
+			m_EditChangePending = true;
+		}
+		return;
+	}
+
+	emit keyframesChanged();
+	emit keyframesRangeChanged(fromTime, toTime, minValue, maxValue);
+}
+
+void AnimationTrack::expandValueRange(int from, int to, double &minValue, double &maxValue) const
+{
+	from = std::max(from, 0);
+	to = std::min(to, m_Keyframes.size() - 1);
+	if (from > to)
+		return;
+
+	// The keyframes themselves, and the handles with Bezier interpolation, which contain the curve
+	for (int i = from; i <= to; ++i)
+	{
+		minValue = std::min(minValue, m_Keyframes.value(i));
+		maxValue = std::max(maxValue, m_Keyframes.value(i));
+	}
+	switch (m_InterpolationMethod)
+	{
+	case AnimationInterpolation::Step:
+	case AnimationInterpolation::Linear:
+		return;
+	case AnimationInterpolation::Bezier: {
+		for (int i = from; i <= to; ++i)
+		{
+			double value = m_Keyframes.value(i);
+			double inTangentY = m_Keyframes.parameter(AnimationKeyframeArray::InTangentY, i);
+			double outTangentY = m_Keyframes.parameter(AnimationKeyframeArray::OutTangentY, i);
+			minValue = std::min(minValue, value + std::min(inTangentY, outTangentY));
+			maxValue = std::max(maxValue, value + std::max(inTangentY, outTangentY));
+		}
+		return;
+	}
+	default:
+		break;
+	}
+
+	// The other methods may overshoot the keyframes, add the extremes of each cubic segment
+	const double *times = m_Keyframes.times();
+	for (int i = from; i < to; ++i)
+	{
+		SegmentPolynomial segment = segmentPolynomial(m_InterpolationMethod, times[i], m_Keyframes.keyframe(i), times[i + 1], m_Keyframes.keyframe(i + 1));
+		expandSegmentRange(segment, minValue, maxValue);
+	}
+}
+
+void AnimationTrack::setName(const QString &name)
+{
+	if (m_Name != name)
+	{
+		m_Name = name;
+		emit nameChanged(name);
+	}
+}
+
+QString AnimationTrack::name() const
+{
+	return m_Name;
+}
+
+void AnimationTrack::setColorRgba(quint32 rgba)
+{
+	if (m_Color != rgba)
+	{
+		m_Color = rgba;
+		emit colorChanged();
+	}
+}
+
+quint32 AnimationTrack::colorRgba() const
+{
+	return m_Color;
+}
+
+// Opaque 0xAARRGGBB from hue in degrees, saturation and lightness in percent
+static quint32 rgbaFromHsl(int hue, int saturation, int lightness)
+{
+	double s = saturation / 100.0;
+	double l = lightness / 100.0;
+	double chroma = (1.0 - std::abs(2.0 * l - 1.0)) * s;
+	double h = (hue % 360) / 60.0;
+	double x = chroma * (1.0 - std::abs(std::fmod(h, 2.0) - 1.0));
+	double r = 0.0, g = 0.0, b = 0.0;
+	switch (static_cast<int>(h))
+	{
+	case 0: r = chroma; g = x; break;
+	case 1: r = x; g = chroma; break;
+	case 2: g = chroma; b = x; break;
+	case 3: g = x; b = chroma; break;
+	case 4: r = x; b = chroma; break;
+	default: r = chroma; b = x; break;
+	}
+	double m = l - chroma * 0.5;
+	auto channel = [m](double c) -> quint32 { return static_cast<quint32>(std::lround((c + m) * 255.0)); };
+	return 0xFF000000u | (channel(r) << 16) | (channel(g) << 8) | channel(b);
+}
+
+void AnimationTrack::setRandomColor()
+{
+	static QRandomGenerator rng(static_cast<quint64>(static_cast<quint64>(std::random_device()())));
+
+	const QString &trackName = m_Name;
+
+	// Generate a random hue between 0 and 359
+	// If the track name contains X, Y, or Z, generate a hue between
+	// -5 and 5 (red), 115 and 125 (green), or 235 and 245 (blue) respectively
+	int hue;
+	if (trackName.contains("X"))
+	{
+		hue = rng.generate() % 10;
+		hue += (360 - 5);
+		hue %= 360;
+	}
+	else if (trackName.contains("Y"))
+	{
+		hue = rng.generate() % 10;
+		hue += (120 - 5);
+	}
+	else if (trackName.contains("Z"))
+	{
+		hue = rng.generate() % 10;
+		hue += (240 - 5);
+	}
+	else
+	{
+		hue = rng.generate() % 360;
+	}
+
+	// Generate saturation between 80% and 90%
+	int saturation = 80 + rng.generate() % 10;
+
+	// Generate lightness between 60% and 70%
+	int lightness = 60 + rng.generate() % 10;
+
+	setColorRgba(rgbaFromHsl(hue, saturation, lightness));
+}
+
+// Bezier to TCB conversion
+void AnimationTrack::convertBezierToTCB(AnimationKeyframeArray &keyframes)
+{
+	convertParameters<KeepParameters, BezierToTCB>(keyframes);
+}
+
+// TCB to Bezier conversion
+void AnimationTrack::convertTCBToBezier(AnimationKeyframeArray &keyframes)
+{
+	convertParameters<TCBToBezier, KeepParameters>(keyframes);
+}
+
+// Bezier to Ease In/Out conversion
+void AnimationTrack::convertBezierToEaseInOut(AnimationKeyframeArray &keyframes)
+{
+	convertParameters<KeepParameters, BezierToEaseInOut>(keyframes);
+}
+
+// Ease In/Out to Bezier conversion
+void AnimationTrack::convertEaseInOutToBezier(AnimationKeyframeArray &keyframes)
+{
+	convertParameters<EaseInOutToBezier, KeepParameters>(keyframes);
+}
+
+void AnimationTrack::convertTCBToEaseInOut(AnimationKeyframeArray &keyframes)
+{
+	double *slot0 = keyframes.parameters(0);
+	double *slot1 = keyframes.parameters(1);
+	for (int i = 0; i < keyframes.size(); ++i)
+	{
+		// Approximate Ease In and Ease Out values based on TCB parameters
+		double easeIn = 1.0 - slot0[i];
+		double easeOut = 1.0 - slot0[i];
+
+		// Update the keyframe with Ease In/Out values
+		slot0[i] = easeIn;
+		slot1[i] = easeOut;
+	}
+}
+
+void AnimationTrack::convertEaseInOutToTCB(AnimationKeyframeArray &keyframes)
+{
+	double *slot0 = keyframes.parameters(0);
+	double *slot1 = keyframes.parameters(1);
+	double *slot2 = keyframes.parameters(2);
+	for (int i = 0; i < keyframes.size(); ++i)
+	{
+		// Approximate TCB parameters based on Ease In/Out values
+		double tension = 1.0 - (slot0[i] + slot1[i]) / 2.0;
+		double continuity = 0.0; // Set to 0.0 as a starting point
+		double bias = 0.0; // Set to 0.0 as a starting point
+
+		// Update the keyframe with TCB parameters
+		slot0[i] = tension;
+		slot1[i] = continuity;
+		slot2[i] = bias;
+	}
+}
+
+double AnimationTrack::valueAtTime(double time) const
+{
+	int size = m_Keyframes.size();
+	if (size == 0)
+		return 0.0;
+
+	// Clamp to the first and last keyframe
+	const double *times = m_Keyframes.times();
+	if (time <= times[0])
+		return m_Keyframes.value(0);
+	if (time >= times[size - 1])
+		return m_Keyframes.value(size - 1);
+
+	// Playback and scrubbing mostly stay within the same segment, or advance to the next one,
+	// so check the cached segment and its successor before falling back to a binary search
+	int index = m_SegmentCursor;
+	if (index < 0 || index >= size - 1 || time < times[index])
+	{
+		index = -1;
+	}
+	else if (time >= times[index + 1])
+	{
+		++index;
+		if (index >= size - 1 || time >= times[index + 1])
+			index = -1;
+	}
+	if (index == -1)
+	{
+		// Last keyframe at or before the time, never the last one due to the clamping above
+		index = m_Keyframes.upperBound(time) - 1;
+	}
+
+	m_SegmentCursor = index;
+	return valueAtSegment(index, time);
+}
+
+double AnimationTrack::valueAtSegment(int index, double time) const
+{
+	SegmentView view = segmentView();
+	return dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) { return evaluator.valueAtSegment(view, index, time); });
+}
+
+void AnimationTrack::setBezierInverseTables(bool enabled)
+{
+	if (m_BezierInverseTables != enabled)
+	{
+		m_BezierInverseTables = enabled;
+		invalidateAllSegments();
+		invalidateSnapshot();
+	}
+}
+
+bool AnimationTrack::bezierInverseTables() const
+{
+	return m_BezierInverseTables;
+}
+
+quint64 AnimationTrack::curveVersion() const
+{
+	return m_CurveVersion;
+}
+
+bool AnimationTrack::valueRange(int from, int to, double &minValue, double &maxValue) const
+{
+	return queryValueRange(from, to, false, minValue, maxValue);
+}
+
+bool AnimationTrack::keyframeValueRange(int from, int to, double &minValue, double &maxValue) const
+{
+	return queryValueRange(from, to, true, minValue, maxValue);
+}
+
+void AnimationTrack::updateValueRanges() const
+{
+	// Rebuild the levels from the first dirty segment on
+	int count = m_Keyframes.size() - 1;
+	if (m_DirtyValueRangesFrom < count || m_ValueRangeLevels.isEmpty() || m_ValueRangeLevels[0].size() != count)
+	{
+		const SegmentPolynomial *segments = this->segments();
+		int dirty = std::min(m_DirtyValueRangesFrom, static_cast<int>(m_ValueRangeLevels.isEmpty() ? 0 : m_ValueRangeLevels[0].size()));
+		int levelCount = 1;
+		for (int size = count; size > 1; size = (size + 1) / 2)
+			++levelCount;
+		m_ValueRangeLevels.resize(levelCount);
+
+		QVector<SegmentValueRange> &segmentRanges = m_ValueRangeLevels[0];
+		segmentRanges.resize(count);
+		for (int i = dirty; i < count; ++i)
+		{
+			double keyLow = std::min(m_Keyframes.value(i), m_Keyframes.value(i + 1));
+			double keyHigh = std::max(m_Keyframes.value(i), m_Keyframes.value(i + 1));
+			double low = keyLow;
+			double high = keyHigh;
+			expandSegmentRange(segments[i], low, high);
+			segmentRanges[i] = { low, high, keyLow, keyHigh };
+		}
+		for (int level = 1, size = count; level < levelCount; ++level)
+		{
+			const QVector<SegmentValueRange> &below = m_ValueRangeLevels[level - 1];
+			QVector<SegmentValueRange> &ranges = m_ValueRangeLevels[level];
+			size = (size + 1) / 2;
+			dirty /= 2;
+			ranges.resize(size);
+			for (int i = dirty; i < size; ++i)
+			{
+				SegmentValueRange range = below[2 * i];
+				if (2 * i + 1 < below.size())
+				{
+					range.Min = std::min(range.Min, below[2 * i + 1].Min);
+					range.Max = std::max(range.Max, below[2 * i + 1].Max);
+					range.KeyMin = std::min(range.KeyMin, below[2 * i + 1].KeyMin);
+					range.KeyMax = std::max(range.KeyMax, below[2 * i + 1].KeyMax);
+				}
+				ranges[i] = range;
+			}
+		}
+		m_DirtyValueRangesFrom = count;
+	}
+}
+
+bool AnimationTrack::queryValueRange(int from, int to, bool keyframesOnly, double &minValue, double &maxValue) const
+{
+	from = std::max(from, 0);
+	to = std::min(to, m_Keyframes.size() - 1);
+	if (from >= to)
+		return false;
+	updateValueRanges();
+
+	// Segments from to to - 1, walking up the levels with the entries that stick out of the next level
+	double low = std::numeric_limits<double>::infinity();
+	double high = -std::numeric_limits<double>::infinity();
+	auto include = [&low, &high, keyframesOnly](const SegmentValueRange &range) {
+		low = std::min(low, keyframesOnly ? range.KeyMin : range.Min);
+		high = std::max(high, keyframesOnly ? range.KeyMax : range.Max);
+	};
+	for (int level = 0; from < to; ++level, from /= 2, to /= 2)
+	{
+		const QVector<SegmentValueRange> &ranges = m_ValueRangeLevels[level];
+		if (from & 1)
+			include(ranges[from++]);
+		if (to & 1)
+			include(ranges[--to]);
+	}
+	minValue = low;
+	maxValue = high;
+	return true;
+}
+
+void AnimationTrack::setStoragePrecision(AnimationKeyframeArray::Precision precision)
+{
+	if (m_Keyframes.precision() == precision)
+		return;
+
+	double minValue = std::numeric_limits<double>::infinity();
+	double maxValue = -std::numeric_limits<double>::infinity();
+	expandValueRange(0, m_Keyframes.size() - 1, minValue, maxValue);
+	m_Keyframes.setPrecision(precision);
+	invalidateKeyframes();
+	expandValueRange(0, m_Keyframes.size() - 1, minValue, maxValue);
+	keyframesEdited(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), minValue, maxValue);
+}
+
+AnimationKeyframeArray::Precision AnimationTrack::storagePrecision() const
+{
+	return m_Keyframes.precision();
+}
+
+const AnimationTrack::SegmentPolynomial *AnimationTrack::segments() const
+{
+	if (m_DirtySegments.isDirty())
+	{
+		buildSegments(m_Keyframes, m_InterpolationMethod, m_BezierInverseTables, m_DirtySegments.From, m_DirtySegments.To, m_Segments.data(), m_SegmentTimings.data());
+		m_DirtySegments.clear();
+	}
+	return m_Segments.constData();
+}
+
+void AnimationTrack::buildSegments(const AnimationKeyframeArray &keyframes, AnimationInterpolation method, bool inverseTables, int from, int to, SegmentPolynomial *segments, SegmentTiming *timings)
+{
+	const double *times = keyframes.times();
+	dispatchAnimationEvaluator(method, [&](auto evaluator) {
+		for (int i = from; i < to; ++i)
+		{
+			AnimationKeyframe k0 = keyframes.keyframe(i);
+			AnimationKeyframe k1 = keyframes.keyframe(i + 1);
+			segments[i] = evaluator.segment(times[i], k0, times[i + 1], k1);
+			if (evaluator.Interpolation == AnimationInterpolation::Bezier)
+				timings[i] = evaluator.timing(times[i], k0, times[i + 1], k1, inverseTables);
+		}
+	});
+}
+
+const AnimationTrack::SegmentTiming *AnimationTrack::segmentTimings() const
+{
+	return m_SegmentTimings.constData();
+}
+
+void AnimationTrack::invalidateSegments(int from, int to) const
+{
+	segmentsChanged(std::max(from, 0));
+	m_DirtySegments.invalidate(from, to, m_Segments.size());
+}
+
+void AnimationTrack::invalidateAllSegments() const
+{
+	segmentsChanged(0);
+	m_Segments.resize(std::max(m_Keyframes.size() - 1, 0));
+	if (m_InterpolationMethod == AnimationInterpolation::Bezier)
+		m_SegmentTimings.resize(m_Segments.size());
+	else
+		m_SegmentTimings.clear();
+	m_DirtySegments.invalidateAll(m_Segments.size());
+}
+
+void AnimationTrack::segmentsChanged(int from) const
+{
+	// The curve changed from segment from on
+	++m_CurveVersion;
+	m_DirtyValueRangesFrom = std::min(m_DirtyValueRangesFrom, from);
+}
+
+void AnimationTrack::keyframeInserted(int index) const
+{
+	keyframesMerged(index, index, 1);
+}
+
+void AnimationTrack::keyframeRemoved(int index) const
+{
+	int first = m_DirtySegments.keyframeRemoved(index, m_Keyframes.size(), m_Segments.size(), 1, [&](int segment) {
+		m_Segments.remove(segment);
+		if (m_InterpolationMethod == AnimationInterpolation::Bezier)
+			m_SegmentTimings.remove(segment);
+	});
+	if (first < 0)
+		invalidateAllSegments();
+	else
+		segmentsChanged(first);
+}
+
+void AnimationTrack::keyframesMerged(int from, int to, int inserted) const
+{
+	// Keyframes were inserted or replaced between from and to, the segments on either side only shift
+	int first = m_DirtySegments.keyframesInserted(from, to, inserted, m_Keyframes.size(), m_Segments.size(), 1, [&](int segment, int added) {
+		m_Segments.insert(segment, added, SegmentPolynomial());
+		if (m_InterpolationMethod == AnimationInterpolation::Bezier)
+			m_SegmentTimings.insert(segment, added, SegmentTiming());
+	});
+	if (first < 0)
+		invalidateAllSegments();
+	else
+		segmentsChanged(first);
+}
+
+std::shared_ptr<const AnimationTrackSnapshot> AnimationTrack::snapshot() const
+{
+	// Only the owning thread reads the keyframes to bring a stale snapshot up to date
+	if (QThread::currentThread() == thread() && m_SnapshotStale && m_EditDepth == 0)
+		buildSnapshot();
+	return std::atomic_load(&m_Snapshot);
+}
+
+void AnimationTrack::publishSnapshot()
+{
+	if (m_EditDepth > 0)
+		m_SnapshotStale = true;
+	else
+		buildSnapshot();
+}
+
+void AnimationTrack::invalidateSnapshot()
+{
+	// A snapshot shares the arrays of the track, so publishing after every edit would make the next edit copy them all
+	m_SnapshotStale = true;
+	if (m_EditDepth == 0)
+		scheduleSnapshot();
+}
+
+void AnimationTrack::scheduleSnapshot()
+{
+	// Consecutive edits are published together once the event loop gets to it
+	if (m_SnapshotScheduled)
+		return;
+	m_SnapshotScheduled = true;
+	QMetaObject::invokeMethod(this, [this]() {
+		m_SnapshotScheduled = false;
+		if (m_SnapshotStale && m_EditDepth == 0)
+			buildSnapshot();
+	}, Qt::QueuedConnection);
+}
+
+void AnimationTrack::buildSnapshot() const
+{
+	// The snapshot shares the segment cache as it is, and rebuilds the dirty segments in its own copy when first evaluated
+	std::shared_ptr<AnimationTrackSnapshot> snapshot = std::make_shared<AnimationTrackSnapshot>();
+	snapshot->m_Version = ++m_SnapshotVersion;
+	snapshot->m_Keyframes = m_Keyframes;
+	snapshot->m_InterpolationMethod = m_InterpolationMethod;
+	snapshot->m_BezierInverseTables = m_BezierInverseTables;
+	snapshot->m_Segments = m_Segments;
+	snapshot->m_SegmentTimings = m_SegmentTimings;
+	snapshot->m_DirtySegments = m_DirtySegments;
+	m_SnapshotStale = false;
+	std::atomic_store(&m_Snapshot, std::shared_ptr<const AnimationTrackSnapshot>(std::move(snapshot)));
+}
+
+AnimationTrack::SegmentView AnimationTrack::segmentView() const
+{
+	SegmentView view;
+	view.Times = m_Keyframes.times();
+	view.Size = m_Keyframes.size();
+	view.FirstValue = view.Size ? m_Keyframes.value(0) : 0.0;
+	view.LastValue = view.Size ? m_Keyframes.value(view.Size - 1) : 0.0;
+	view.Segments = segments();
+	view.Timings = m_InterpolationMethod == AnimationInterpolation::Bezier ? segmentTimings() : nullptr;
+	view.InverseTables = m_BezierInverseTables;
+	return view;
+}
+
+void AnimationTrack::sample(const double *times, double *out, size_t count) const
+{
+	SegmentView view = segmentView();
+	dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) { evaluator.sample(view, times, out, count); });
+}
+
+void AnimationTrack::sampleRange(double fromTime, double timeStep, size_t count, double *out) const
+{
+	SegmentView view = segmentView();
+	dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) { evaluator.sampleRange(view, fromTime, timeStep, count, out); });
+}
+
+void AnimationTrack::evaluateTracks(const AnimationTrack *const *tracks, int count, double time, double *out)
+{
+	// Chunks are large enough that scheduling them costs little compared to evaluating them
+	runChunks(count, 512, [&](int begin, int end) {
+		for (int i = begin; i < end; ++i)
+			out[i] = tracks[i]->valueAtTime(time);
+	});
+}
+
+AnimationBakedTrack AnimationTrack::bake(double sampleRate, AnimationBakedTrack::Reconstruction reconstruction) const
+{
+	AnimationBakedTrack baked;
+	baked.m_Reconstruction = reconstruction;
+	int size = m_Keyframes.size();
+	if (size == 0 || !(sampleRate > 0.0) || !std::isfinite(sampleRate))
+		return baked;
+
+	// The last sample is at or just past the last keyframe, the table is left empty when the samples do not fit an int
+	double firstTime = m_Keyframes.time(0);
+	double duration = m_Keyframes.time(size - 1) - firstTime;
+	double intervals = std::ceil(duration * sampleRate - 1e-9);
+	if (!(intervals < static_cast<double>(std::numeric_limits<int>::max())))
+		return baked;
+	int count = static_cast<int>(std::max(intervals, 0.0)) + 1;
+	baked.m_StartTime = firstTime;
+	baked.m_SampleRate = sampleRate;
+	baked.m_Samples.resize(count);
+	sampleRange(firstTime, 1.0 / sampleRate, count, baked.m_Samples.data());
+
+	// Compare against the source at and between the samples, a chunk at a time so the reference stays small
+	const int oversampling = 4;
+	const int chunkSize = 4096;
+	size_t checkCount = static_cast<size_t>(count - 1) * oversampling + 1;
+	double checkStep = 1.0 / (sampleRate * oversampling);
+	QVector<double> reference(chunkSize);
+	double maxError = 0.0;
+	for (size_t from = 0; from < checkCount; from += chunkSize)
+	{
+		size_t chunk = std::min(static_cast<size_t>(chunkSize), checkCount - from);
+		double chunkTime = firstTime + from * checkStep;
+		sampleRange(chunkTime, checkStep, chunk, reference.data());
+		for (size_t i = 0; i < chunk; ++i)
+			maxError = std::max(maxError, std::abs(baked.valueAtTime(chunkTime + i * checkStep) - reference[static_cast<int>(i)]));
+	}
+	baked.m_MaxError = maxError;
+
+	return baked;
+}
+
+AnimationTrack::SegmentPolynomial AnimationTrack::segmentPolynomial(AnimationInterpolation method, double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1)
+{
+	return dispatchAnimationEvaluator(method, [&](auto evaluator) { return evaluator.segment(t0, k0, t1, k1); });
+}
+
+double AnimationTrack::interpolateLinear(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t)
+{
+	typedef AnimationEvaluator<AnimationInterpolation::Linear> Evaluator;
+	return Evaluator::evaluate(Evaluator::segment(t0, k0, t1, k1), nullptr, t, false);
+}
+
+double AnimationTrack::interpolateBezier(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t)
+{
+	typedef AnimationEvaluator<AnimationInterpolation::Bezier> Evaluator;
+	Evaluator::Timing timing = Evaluator::timing(t0, k0, t1, k1, false);
+	return Evaluator::evaluate(Evaluator::segment(t0, k0, t1, k1), &timing, t, false);
+}
+
+double AnimationTrack::interpolateTCB(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t)
+{
+	typedef AnimationEvaluator<AnimationInterpolation::TCB> Evaluator;
+	return Evaluator::evaluate(Evaluator::segment(t0, k0, t1, k1), nullptr, t, false);
+}
+
+double AnimationTrack::interpolateEaseInOut(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t)
+{
+	typedef AnimationEvaluator<AnimationInterpolation::EaseInOut> Evaluator;
+	return Evaluator::evaluate(Evaluator::segment(t0, k0, t1, k1), nullptr, t, false);
+}
+
+void AnimationTrack::convertInterpolation(AnimationKeyframeArray &keyframes, AnimationInterpolation from, AnimationInterpolation to)
+{
+	if (from == to)
+	{
+		return; // No conversion needed
+	}
+
+	// The conversions work on the parameter arrays, so convert in full precision and round the result
+	AnimationKeyframeArray::Precision precision = keyframes.precision();
+	if (precision != AnimationKeyframeArray::Precision::Double)
+	{
+		keyframes.setPrecision(AnimationKeyframeArray::Precision::Double);
+		convertInterpolation(keyframes, from, to);
+		keyframes.setPrecision(precision);
+		return;
+	}
+
+	// Through Bezier handles, in a single pass over the parameters
+	switch (from)
+	{
+	case AnimationInterpolation::Bezier:
+		convertParameters<KeepParameters>(keyframes, to);
+		break;
+	case AnimationInterpolation::TCB:
+		convertParameters<TCBToBezier>(keyframes, to);
+		break;
+	case AnimationInterpolation::EaseInOut:
+		convertParameters<EaseInOutToBezier>(keyframes, to);
+		break;
+	default:
+		convertParameters<DefaultToBezier>(keyframes, to);
+		break;
+	}
+}
+
+void AnimationTrack::convertKeyframeArrays(AnimationKeyframeArray *keyframes, const AnimationInterpolation *from, int count, AnimationInterpolation to)
+{
+	runChunks(count, 16, [&](int begin, int end) {
+		for (int i = begin; i < end; ++i)
+			convertInterpolation(keyframes[i], from[i], to);
+	});
+}
+
+void AnimationTrack::convertInterpolationMethod(AnimationTrack *const *tracks, int count, AnimationInterpolation interpolationMethod)
+{
+	// Convert copies in parallel, then apply them here, as the tracks emit signals and report to their journals
+	QVector<AnimationKeyframeArray> keyframes(count);
+	QVector<AnimationInterpolation> from(count);
+	for (int i = 0; i < count; ++i)
+	{
+		keyframes[i] = tracks[i]->m_Keyframes;
+		from[i] = tracks[i]->m_InterpolationMethod;
+	}
+	convertKeyframeArrays(keyframes.data(), from.constData(), count, interpolationMethod);
+	for (int i = 0; i < count; ++i)
+	{
+		if (from[i] != interpolationMethod)
+			tracks[i]->setKeyframes(keyframes[i], interpolationMethod);
+	}
+}
+
+/*
+
+# ChatGPT Dump
+
+We have developed a time scrubber for an animation system with support for different interpolation methods, including Bezier, TCB (Tension, Continuity, Bias), and Ease In/Out. The core component of the system is the `AnimationKeyframe` class, which stores keyframe data and interpolation parameters specific to each method. The class uses a union to store these parameters efficiently.
+
+We have implemented functions to convert between the different interpolation methods, enabling seamless transitions and providing flexibility for animators. These functions are:
+1. `convertBezierToTCB` and `convertTCBToBezier`
+2. `convertBezierToEaseInOut` and `convertEaseInOutToBezier`
+3. `convertTCBToEaseInOut` and `convertEaseInOutToTCB`
+
+We have also implemented interpolation functions for each method, which calculate the interpolated value given two keyframes and a time value:
+1. `interpolateBezier`
+2. `interpolateTCB`
+3. `interpolateEaseInOut`
+
+The system is functional and provides a good foundation for building upon. However, further improvements can be planned and implemented, such as:
+1. Optimizing the conversion and interpolation functions for better performance.
+2. Implementing additional interpolation methods, like Quaternion Slerp for rotations or other spline-based interpolations.
+3. Enhancing the user interface for the time scrubber and easing the process of selecting and modifying keyframes.
+4. Adding support for keyframe channels, which would allow for simultaneous manipulation of multiple properties.
+
+This summary should provide a clear understanding of the current state of the time scrubber and its underlying components, enabling the planning of future improvements and extensions.
+
+- Consider using QPointF for Bezier handle representation:
+Instead of using separate variables for X and Y coordinates of InTangent and OutTangent,
+you can use QPointF from the Qt library to represent the coordinates as a single object.
+
+*/
+
+/* end of file */
@@ -0,0 +1,450 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+The AnimationTrack class provides a simple and efficient way to manage and
+manipulate keyframe-based animations. It stores keyframes as sorted contiguous
+arrays in an AnimationKeyframeArray, and provides a QMap view with time values
+as keys and AnimationKeyframe objects as values for compatibility. It also
+supports multiple interpolation methods for smooth transitions between keyframes.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_TRACK__H
+#define ANIMATION_TRACK__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QPair>
+#include <QString>
+#include <QPointer>
+#ifdef QT_GUI_LIB
+#include <QColor>
+#endif
+
+#include <memory>
+
+#include "AnimationKeyframe.h"
+#include "AnimationEvaluator.h"
+#include "AnimationKeyframeArray.h"
+#include "AnimationSegmentCache.h"
+#include "AnimationBakedTrack.h"
+
+// Back-reference for the editor, never dereferenced by the track itself
+class QTreeWidgetItem;
+
+class AnimationTrackSnapshot;
+class AnimationUndoJournal;
+class AnimationKeyframeIndex;
+
+class AnimationEditor;
+class AnimationTimelineEditor;
+class AnimationCurveEditor;
+
+class ANIMATIONCORE_EXPORT AnimationTrack : public QObject
+{
+	Q_OBJECT
+
+public:
+	typedef QMap<double, AnimationKeyframe> KeyframeMap;
+	explicit AnimationTrack(QObject *parent = nullptr);
+	virtual ~AnimationTrack();
+
+	// Getters
+	const AnimationKeyframeArray &keyframeArray() const;
+	const KeyframeMap &keyframes() const; // Compatibility view, rebuilt on first use after a change
+	AnimationInterpolation interpolationMethod() const;
+
+	// Setters
+	void setKeyframes(const AnimationKeyframeArray &keyframes);
+	void setKeyframes(const KeyframeMap &keyframes);
+	void setInterpolationMethod(AnimationInterpolation interpolationMethod);
+	void setKeyframes(const AnimationKeyframeArray &keyframes, AnimationInterpolation interpolationMethod); // As one edit
+
+	// Change the interpolation method, converting the interpolation parameters of the keyframes to approximate the curve
+	void convertInterpolationMethod(AnimationInterpolation interpolationMethod);
+
+	// Convert many tracks at once, the parameters are converted in parallel and applied on the calling thread
+	static void convertInterpolationMethod(AnimationTrack *const *tracks, int count, AnimationInterpolation interpolationMethod);
+
+	// Convert the parameters of keyframe arrays from their interpolation method from[i], splitting them over the global
+	// thread pool like evaluateTracks, this does not touch any track, so copies of the keyframes can be converted
+	// on a worker thread and applied with setKeyframes when done
+	static void convertKeyframeArrays(AnimationKeyframeArray *keyframes, const AnimationInterpolation *from, int count, AnimationInterpolation to);
+
+	// Keyframe manipulation
+	void upsertKeyframe(double time, const AnimationKeyframe &keyframe);
+	void insertKeyframe(double time, const AnimationKeyframe &keyframe); // As upsertKeyframe, but keeps the ID of the keyframe
+	void upsertKeyframes(const QVector<QPair<double, AnimationKeyframe>> &keyframes); // Sorted once and merged in linear time
+	void removeKeyframe(double time);
+	void moveKeyframe(double fromTime, double toTime);
+
+	void setName(const QString &name);
+	QString name() const;
+
+	// Color as 0xAARRGGBB, the QColor overloads are available to targets linking QtGui
+	void setColorRgba(quint32 rgba);
+	quint32 colorRgba() const;
+#ifdef QT_GUI_LIB
+	inline void setColor(const QColor &color) { setColorRgba(color.rgba()); }
+	inline QColor color() const { return QColor::fromRgba(colorRgba()); }
+#endif
+
+	void setRandomColor();
+
+	// Batched editing
+	// Between beginEdit and the matching endEdit the keyframe manipulation functions do not publish
+	// snapshots or emit keyframesChanged, the outermost endEdit does so once for the whole batch
+	// Use this when importing, pasting or scripting many edits, calls may be nested
+	void beginEdit();
+	void endEdit();
+	bool isEditing() const;
+
+	// Calls beginEdit on construction and endEdit on destruction
+	class EditScope
+	{
+	public:
+		inline explicit EditScope(AnimationTrack *track) : m_Track(track) { m_Track->beginEdit(); }
+		inline ~EditScope() { m_Track->endEdit(); }
+
+	private:
+		Q_DISABLE_COPY(EditScope)
+		AnimationTrack *m_Track;
+
+	};
+
+	// Undo
+	// While the journal records a command, the changes to the keyframes and the interpolation method are reported to it
+	void setUndoJournal(AnimationUndoJournal *journal);
+	AnimationUndoJournal *undoJournal() const;
+
+	// Keyframe ID index, which is kept up to date with the keyframes of the track
+	void setKeyframeIndex(AnimationKeyframeIndex *index);
+	AnimationKeyframeIndex *keyframeIndex() const;
+
+	// Evaluation
+	// Segment polynomials are cached, and the segments touched by an edit are rebuilt by the first
+	// evaluation that follows, so evaluation is not safe to call concurrently on the same track
+	// The single argument version also caches the last segment it located for the next call
+	double valueAtTime(double time) const;
+
+	// Batched evaluation into a contiguous buffer, walking the segments instead of searching for every sample
+	// Ascending times are fastest, but not required, and these do not touch the segment cursor
+	void sample(const double *times, double *out, size_t count) const;
+	void sampleRange(double fromTime, double timeStep, size_t count, double *out) const;
+
+	// Evaluate many tracks at the same time into out[0..count), splitting them in chunks over the global thread pool
+	// The calling thread takes part, so this also completes when the pool is busy, none of the tracks may be modified meanwhile
+	static void evaluateTracks(const AnimationTrack *const *tracks, int count, double time, double *out);
+
+	// Sample the track at a uniform rate from the first to the last keyframe, into an immutable table
+	// The table is empty when the rate is not finite and positive, or when the samples would not fit an int
+	AnimationBakedTrack bake(double sampleRate, AnimationBakedTrack::Reconstruction reconstruction = AnimationBakedTrack::Reconstruction::Linear) const;
+
+	// Latest published immutable copy of the keyframes, which can be taken and evaluated from any thread
+	// while the track is being edited, include AnimationTrackSnapshot.h to use it
+	// Edits are published when the thread that owns the track takes a snapshot outside of beginEdit and endEdit,
+	// or once its event loop runs, other threads get the last published snapshot until then
+	std::shared_ptr<const AnimationTrackSnapshot> snapshot() const;
+
+	// Publish the current keyframes as a new snapshot right away, the keyframe manipulation functions
+	// schedule this automatically, it is only needed after modifying the keyframes through other means
+	// While editing, publishing is deferred to endEdit
+	void publishSnapshot();
+
+	// Bezier segments are evaluated by solving the handle curve for the time, when enabled a small
+	// inverse table is built per segment to start the solve close to the result, on by default
+	void setBezierInverseTables(bool enabled);
+	bool bezierInverseTables() const;
+
+	// Incremented by every change to the curve, including edits within beginEdit and endEdit,
+	// to validate caches built from the keyframes, such as the painted curves of the editor
+	quint64 curveVersion() const;
+
+	// Lowest and highest value of the curve between keyframe indices from and to, including the extremes of
+	// the segments in between, from a min/max pyramid of the segments at power of two resolutions that is
+	// updated from the first changed segment on the next call, so that a view with many keyframes per pixel
+	// can summarize them in logarithmic time, returns false when there is no segment between from and to
+	bool valueRange(int from, int to, double &minValue, double &maxValue) const;
+
+	// Lowest and highest value of the keyframes from to to inclusive, without the extremes of the segments,
+	// from the same pyramid, so a summary of many keyframes sits on values that keyframes actually have,
+	// returns false when from is not below to
+	bool keyframeValueRange(int from, int to, double &minValue, double &maxValue) const;
+
+	// Precision of the stored keyframe values and interpolation parameters, Double by default
+	// Float and Half keep long and dense tracks resident in less memory, evaluation still returns double
+	// Lowering it rounds the keyframes, which is reported as a change but not recorded by the undo journal
+	void setStoragePrecision(AnimationKeyframeArray::Precision precision);
+	AnimationKeyframeArray::Precision storagePrecision() const;
+
+signals:
+	void keyframesChanged();
+	// Emitted right after keyframesChanged, the curve is unchanged outside of this time range
+	// The range is infinite on the sides where the first or last keyframe changed, as the curve is held flat beyond them
+	// The values of the curve before and after the change stay within the value range, which includes the
+	// Bezier handles, it is empty (minValue > maxValue) when the track had and has no keyframes
+	void keyframesRangeChanged(double fromTime, double toTime, double minValue, double maxValue);
+	void interpolationMethodChanged();
+	void colorChanged();
+	void nameChanged(const QString &name);
+
+private:
+	friend AnimationEditor;
+	friend AnimationTimelineEditor;
+	friend AnimationCurveEditor;
+	friend AnimationTrackSnapshot;
+	friend AnimationUndoJournal;
+	friend AnimationKeyframeIndex;
+
+	AnimationKeyframeArray m_Keyframes;
+	AnimationInterpolation m_InterpolationMethod;
+	QTreeWidgetItem *m_TreeWidgetItem;
+	QString m_Name;
+	quint32 m_Color;
+
+	// Map view of m_Keyframes, rebuilt on first use after a change
+	mutable KeyframeMap m_KeyframeMap;
+	mutable bool m_KeyframeMapValid;
+	void invalidateKeyframeMap() const;
+
+	// Index of the last evaluated segment, validated against the keyframe times on use
+	mutable int m_SegmentCursor;
+
+	// Must be called whenever m_Keyframes is modified directly, drops the map view and all cached segments
+	void invalidateKeyframes() const;
+
+	// As setKeyframes, including the parameters that are not used by the interpolation method
+	void replaceKeyframes(const AnimationKeyframeArray &keyframes);
+
+	double valueAtSegment(int index, double time) const;
+
+	static void convertBezierToTCB(AnimationKeyframeArray &keyframes);
+	static void convertTCBToBezier(AnimationKeyframeArray &keyframes);
+	static void convertBezierToEaseInOut(AnimationKeyframeArray &keyframes);
+	static void convertEaseInOutToBezier(AnimationKeyframeArray &keyframes);
+	static void convertTCBToEaseInOut(AnimationKeyframeArray &keyframes);
+	static void convertEaseInOutToTCB(AnimationKeyframeArray &keyframes);
+
+	static void convertInterpolation(AnimationKeyframeArray &keyframes, AnimationInterpolation from, AnimationInterpolation to);
+
+	// Cached evaluation data, see AnimationEvaluator
+	typedef AnimationCurveSegment<double> SegmentPolynomial;
+	typedef AnimationBezierTiming<double> SegmentTiming;
+	typedef AnimationCurveView<double> SegmentView;
+
+	// Cached polynomial for every segment, m_Segments[i] spans keyframes i and i + 1
+	// Segments in the dirty range are rebuilt on the next evaluation
+	mutable QVector<SegmentPolynomial> m_Segments;
+	mutable AnimationSegmentCacheRange m_DirtySegments;
+	mutable quint64 m_CurveVersion;
+
+	// Value range of every segment, then of every two entries of the level below, up to a single entry
+	// The levels are rebuilt from the first dirty segment on, as inserting or removing keyframes shifts the rest
+	// Min and Max include the extremes of the segment, KeyMin and KeyMax only its two keyframes
+	struct SegmentValueRange
+	{
+		double Min;
+		double Max;
+		double KeyMin;
+		double KeyMax;
+	};
+	mutable QVector<QVector<SegmentValueRange>> m_ValueRangeLevels;
+	mutable int m_DirtyValueRangesFrom;
+	void updateValueRanges() const;
+	bool queryValueRange(int from, int to, bool keyframesOnly, double &minValue, double &maxValue) const;
+
+	// Time curve of every segment, only used with Bezier interpolation, parallel to m_Segments
+	mutable QVector<SegmentTiming> m_SegmentTimings;
+	bool m_BezierInverseTables;
+
+	// Published snapshot, only replaced from the thread that owns the track, read atomically from any thread
+	// A stale snapshot is replaced when taken on the owning thread, or by the scheduled publish
+	mutable std::shared_ptr<const AnimationTrackSnapshot> m_Snapshot;
+	mutable quint64 m_SnapshotVersion;
+	mutable bool m_SnapshotStale;
+	bool m_SnapshotScheduled;
+
+	// Batched editing state, the pending time range is the union of all the edits since the outermost beginEdit
+	int m_EditDepth;
+	bool m_EditChangePending;
+	double m_EditFromTime;
+	double m_EditToTime;
+	double m_EditMinValue;
+	double m_EditMaxValue;
+
+	// Journal to report the changes to, null unless it is recording a command
+	QPointer<AnimationUndoJournal> m_UndoJournal;
+	AnimationUndoJournal *recordingJournal() const;
+
+	// Index of the keyframe IDs, if any
+	QPointer<AnimationKeyframeIndex> m_KeyframeIndex;
+
+	// Report keyframes leaving and entering the track to the recording journal and the index,
+	// a keyframe that changes is reported as removed and inserted again
+	bool reportsKeyframes() const;
+	void reportKeyframeRemoved(double time, const AnimationKeyframe &keyframe);
+	void reportKeyframeInserted(double time, const AnimationKeyframe &keyframe);
+
+	// Mark the snapshot stale, and schedule publishing it unless editing
+	void invalidateSnapshot();
+	void scheduleSnapshot();
+	void buildSnapshot() const;
+
+	// Notify the change of the curve between keyframe indices from and to, or beyond the ends when out of range
+	void keyframesEdited(int from, int to, double minValue, double maxValue);
+	void keyframesEdited(double fromTime, double toTime, double minValue, double maxValue);
+
+	// Grow the value range to contain the curve between keyframe indices from and to, clamped to the keyframes
+	void expandValueRange(int from, int to, double &minValue, double &maxValue) const;
+
+	// Everything the evaluators need, shared by the track and its snapshots
+	// Timings is null unless the interpolation method is Bezier
+	SegmentView segmentView() const;
+
+	const SegmentPolynomial *segments() const;
+	const SegmentTiming *segmentTimings() const; // Valid after segments()
+	static void buildSegments(const AnimationKeyframeArray &keyframes, AnimationInterpolation method, bool inverseTables, int from, int to, SegmentPolynomial *segments, SegmentTiming *timings);
+	void invalidateSegments(int from, int to) const;
+	void invalidateAllSegments() const;
+	void segmentsChanged(int from) const;
+	void keyframeInserted(int index) const;
+	void keyframeRemoved(int index) const;
+	void keyframesMerged(int from, int to, int inserted) const;
+
+	static SegmentPolynomial segmentPolynomial(AnimationInterpolation method, double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1);
+
+	static double interpolateLinear(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t);
+	static double interpolateBezier(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t);
+	static double interpolateTCB(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t);
+	static double interpolateEaseInOut(double t0, const AnimationKeyframe &k0, double t1, const AnimationKeyframe &k1, double t);
+
+}; /* class AnimationTrack */
+
+#if 0
+
+// Summarized copy
+
+enum class AnimationInterpolation
+{
+	Step,
+	Linear,
+	Bezier,
+	TensionContinuityBias,
+	EaseInOut,
+};
+
+struct ANIMATIONCORE_EXPORT AnimationKeyframe
+{
+	// Identifier for the UI
+	ptrdiff_t Id;
+
+	// Value on Y-axis
+	double Value;
+
+	// Interpolation data for different methods
+	union InterpolationData
+	{
+		// Bezier handles, relative to the keyframe
+		struct
+		{
+			double InTangentX;
+			double InTangentY;
+			double OutTangentX;
+			double OutTangentY;
+		} Bezier;
+
+		// TCB interpolation parameters
+		struct
+		{
+			double Tension;
+			double Continuity;
+			double Bias;
+		} TCB;
+
+		// Ease In/Out interpolation parameters
+		struct
+		{
+			double EaseIn;
+			double EaseOut;
+		} EaseInOut;
+	} Interpolation;
+
+private:
+	friend AnimationTrack;
+
+}; /* class AnimationKeyframe */
+
+class ANIMATIONCORE_EXPORT AnimationTrack : QObject
+{
+	Q_OBJECT
+
+public:
+	explicit AnimationTrack(QObject *parent = nullptr);
+
+	// Getters
+	const QMap<double, AnimationKeyframe> &keyframes() const;
+	AnimationInterpolation interpolationMethod() const;
+
+	// Setters
+	void setKeyframes(const QMap<double, AnimationKeyframe> &keyframes);
+	void setInterpolationMethod(AnimationInterpolation interpolationMethod);
+
+	// Keyframe manipulation
+	void upsertKeyframe(double time, const AnimationKeyframe &keyframe);
+	void removeKeyframe(double time);
+	void moveKeyframe(double fromTime, double toTime);
+
+signals:
+	void keyframesChanged();
+	void interpolationMethodChanged();
+
+private:
+	friend AnimationEditor;
+	friend AnimationTimelineEditor;
+	friend AnimationCurveEditor;
+
+	QMap<double, AnimationKeyframe> m_Keyframes;
+	AnimationInterpolation m_InterpolationMethod;
+	QTreeWidgetItem *m_TreeWidgetItem;
+
+}; /* class AnimationTrack */
+
+#endif
+
+#endif /* ANIMATION_TRACK__H */
+
+/* end of file */
@@ -0,0 +1,80 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationTrackSnapshot.h"
+
+AnimationTrackSnapshot::AnimationTrackSnapshot()
+    : m_Version(0)
+    , m_InterpolationMethod(AnimationInterpolation::Linear)
+    , m_BezierInverseTables(true)
+{
+}
+
+AnimationTrack::SegmentView AnimationTrackSnapshot::segmentView() const
+{
+	// Concurrent readers wait for the first one to finish the rebuild, which detaches the arrays from the track
+	if (m_DirtySegments.isDirty())
+	{
+		std::call_once(m_SegmentsBuilt, [this]() {
+			AnimationTrack::buildSegments(m_Keyframes, m_InterpolationMethod, m_BezierInverseTables, m_DirtySegments.From, m_DirtySegments.To, m_Segments.data(), m_SegmentTimings.data());
+		});
+	}
+
+	AnimationTrack::SegmentView view;
+	view.Times = m_Keyframes.times();
+	view.Size = m_Keyframes.size();
+	view.FirstValue = view.Size ? m_Keyframes.value(0) : 0.0;
+	view.LastValue = view.Size ? m_Keyframes.value(view.Size - 1) : 0.0;
+	view.Segments = m_Segments.constData();
+	view.Timings = m_InterpolationMethod == AnimationInterpolation::Bezier ? m_SegmentTimings.constData() : nullptr;
+	view.InverseTables = m_BezierInverseTables;
+	return view;
+}
+
+double AnimationTrackSnapshot::valueAtTime(double time) const
+{
+	AnimationTrack::SegmentView view = segmentView();
+	return dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) { return evaluator.valueAtTime(view, time); });
+}
+
+void AnimationTrackSnapshot::sample(const double *times, double *out, size_t count) const
+{
+	AnimationTrack::SegmentView view = segmentView();
+	dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) { evaluator.sample(view, times, out, count); });
+}
+
+void AnimationTrackSnapshot::sampleRange(double fromTime, double timeStep, size_t count, double *out) const
+{
+	AnimationTrack::SegmentView view = segmentView();
+	dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) { evaluator.sampleRange(view, fromTime, timeStep, count, out); });
+}
+
+/* end of file */
@@ -0,0 +1,91 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationTrackSnapshot is an immutable copy of the keyframes of a track,
+together with its cached segment polynomials, as published by the track
+after a series of changes. The arrays are implicitly shared with the track
+until it modifies them, so publishing a snapshot does not copy the keyframes.
+
+Snapshots are taken with AnimationTrack::snapshot, which can be called from
+any thread, and are never modified afterwards, so worker threads can keep
+evaluating the version they took without locks while the track is edited.
+Compare versions to find out whether a newer one was published.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_TRACK_SNAPSHOT__H
+#define ANIMATION_TRACK_SNAPSHOT__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <mutex>
+
+#include "AnimationTrack.h"
+
+class ANIMATIONCORE_EXPORT AnimationTrackSnapshot
+{
+public:
+	AnimationTrackSnapshot();
+
+	// Getters
+	quint64 version() const { return m_Version; }
+	const AnimationKeyframeArray &keyframes() const { return m_Keyframes; }
+	AnimationInterpolation interpolationMethod() const { return m_InterpolationMethod; }
+
+	// Evaluation, safe to call concurrently
+	double valueAtTime(double time) const;
+	void sample(const double *times, double *out, size_t count) const;
+	void sampleRange(double fromTime, double timeStep, size_t count, double *out) const;
+
+private:
+	friend AnimationTrack;
+
+	AnimationTrack::SegmentView segmentView() const;
+
+	quint64 m_Version;
+	AnimationKeyframeArray m_Keyframes;
+	AnimationInterpolation m_InterpolationMethod;
+	bool m_BezierInverseTables;
+
+	// Segments as cached by the track when published, the dirty ones are rebuilt once on the first evaluation
+	mutable QVector<AnimationTrack::SegmentPolynomial> m_Segments;
+	mutable QVector<AnimationTrack::SegmentTiming> m_SegmentTimings;
+	AnimationSegmentCacheRange m_DirtySegments;
+	mutable std::once_flag m_SegmentsBuilt;
+
+}; /* class AnimationTrackSnapshot */
+
+#endif /* ANIMATION_TRACK_SNAPSHOT__H */
+
+/* end of file */
@@ -0,0 +1,569 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationUndoJournal.h"
+
+#include <QSet>
+#include <algorithm>
+
+#include "AnimationTrack.h"
+#include "AnimationKeyframeIndex.h"
+
+namespace {
+
+// Replaying a change touching more than this fraction of a track rebuilds the track in one pass,
+// instead of inserting and removing the keyframes one by one
+const int ReplayRebuildDivisor = 16;
+
+const qint64 DefaultMemoryBudget = 64 * 1024 * 1024;
+
+} /* anonymous namespace */
+
+AnimationUndoJournal::AnimationUndoJournal(QObject *parent)
+    : QObject(parent)
+    , m_Index(0)
+    , m_MemoryUsage(0)
+    , m_MemoryBudget(DefaultMemoryBudget)
+    , m_RecordDepth(0)
+    , m_RecordMerge(false)
+    , m_MergeOpen(false)
+    , m_MergeIntoLast(false)
+{
+}
+
+void AnimationUndoJournal::beginCommand(const QString &text, bool mergeWithPrevious)
+{
+	if (m_RecordDepth++ == 0)
+	{
+		m_Recording.Text = text;
+		m_RecordMerge = mergeWithPrevious;
+	}
+}
+
+void AnimationUndoJournal::endCommand()
+{
+	Q_ASSERT(m_RecordDepth > 0);
+	if (--m_RecordDepth == 0)
+	{
+		m_RecordingTracks.clear();
+		m_RecordingIds.clear();
+		pushCommand(m_RecordMerge);
+		m_Recording = Command();
+	}
+}
+
+bool AnimationUndoJournal::isRecording() const
+{
+	return m_RecordDepth > 0;
+}
+
+bool AnimationUndoJournal::canUndo() const
+{
+	return m_Index > 0;
+}
+
+bool AnimationUndoJournal::canRedo() const
+{
+	return m_Index < m_Commands.size();
+}
+
+QString AnimationUndoJournal::undoText() const
+{
+	return canUndo() ? m_Commands[m_Index - 1].Text : QString();
+}
+
+QString AnimationUndoJournal::redoText() const
+{
+	return canRedo() ? m_Commands[m_Index].Text : QString();
+}
+
+int AnimationUndoJournal::count() const
+{
+	return m_Commands.size();
+}
+
+int AnimationUndoJournal::index() const
+{
+	return m_Index;
+}
+
+void AnimationUndoJournal::clear()
+{
+	int index = m_Index;
+	bool couldUndo = canUndo();
+	bool couldRedo = canRedo();
+	QString previousUndoText = undoText();
+	QString previousRedoText = redoText();
+
+	m_Commands.clear();
+	m_Index = 0;
+	m_MemoryUsage = 0;
+	m_MergeOpen = false;
+	m_MergeIntoLast = false;
+
+	historyChanged(index, couldUndo, couldRedo, previousUndoText, previousRedoText);
+}
+
+void AnimationUndoJournal::setMemoryBudget(qint64 bytes)
+{
+	int index = m_Index;
+	bool couldUndo = canUndo();
+	bool couldRedo = canRedo();
+	QString previousUndoText = undoText();
+	QString previousRedoText = redoText();
+
+	m_MemoryBudget = bytes;
+	enforceMemoryBudget();
+
+	historyChanged(index, couldUndo, couldRedo, previousUndoText, previousRedoText);
+}
+
+qint64 AnimationUndoJournal::memoryBudget() const
+{
+	return m_MemoryBudget;
+}
+
+qint64 AnimationUndoJournal::memoryUsage() const
+{
+	return m_MemoryUsage;
+}
+
+void AnimationUndoJournal::undo()
+{
+	// The tracks would report the replayed changes into the command being recorded
+	if (!canUndo() || isRecording())
+		return;
+
+	int index = m_Index;
+	QString previousUndoText = undoText();
+	QString previousRedoText = redoText();
+
+	const Command &command = m_Commands[m_Index - 1];
+	for (int i = command.Tracks.size() - 1; i >= 0; --i)
+		replay(command.Tracks[i], true);
+	--m_Index;
+	m_MergeOpen = false;
+
+	historyChanged(index, true, index < m_Commands.size(), previousUndoText, previousRedoText);
+}
+
+void AnimationUndoJournal::redo()
+{
+	if (!canRedo() || isRecording())
+		return;
+
+	int index = m_Index;
+	QString previousUndoText = undoText();
+	QString previousRedoText = redoText();
+
+	const Command &command = m_Commands[m_Index];
+	for (const TrackChange &change : command.Tracks)
+		replay(change, false);
+	++m_Index;
+	m_MergeOpen = false;
+
+	historyChanged(index, index > 0, true, previousUndoText, previousRedoText);
+}
+
+void AnimationUndoJournal::keyframeRemoved(AnimationTrack *track, double time, const AnimationKeyframe &keyframe)
+{
+	bool added;
+	KeyframeChange &change = recordingKeyframe(track, keyframe.Id, added);
+	if (added)
+		change.Before = { true, time, keyframe };
+	change.After = { false, 0.0, AnimationKeyframe() };
+}
+
+void AnimationUndoJournal::keyframeInserted(AnimationTrack *track, double time, const AnimationKeyframe &keyframe)
+{
+	bool added;
+	KeyframeChange &change = recordingKeyframe(track, keyframe.Id, added);
+	if (added)
+		change.Before = { false, 0.0, AnimationKeyframe() };
+	change.After = { true, time, keyframe };
+}
+
+void AnimationUndoJournal::interpolationMethodChanged(AnimationTrack *track, AnimationInterpolation from, AnimationInterpolation to)
+{
+	TrackChange &change = recordingTrack(track);
+	if (!change.InterpolationMethodChanged)
+	{
+		change.InterpolationMethodChanged = true;
+		change.InterpolationMethodBefore = from;
+	}
+	change.InterpolationMethodAfter = to;
+}
+
+void AnimationUndoJournal::trackAttached(AnimationTrack *track)
+{
+	connect(track, &QObject::destroyed, this, &AnimationUndoJournal::trackDestroyed);
+}
+
+void AnimationUndoJournal::trackDetached(AnimationTrack *track)
+{
+	disconnect(track, &QObject::destroyed, this, &AnimationUndoJournal::trackDestroyed);
+	dropTrack(track);
+}
+
+void AnimationUndoJournal::trackDestroyed(QObject *track)
+{
+	dropTrack(track);
+}
+
+void AnimationUndoJournal::dropTrack(const QObject *track)
+{
+	int index = m_Index;
+	bool couldUndo = canUndo();
+	bool couldRedo = canRedo();
+	QString previousUndoText = undoText();
+	QString previousRedoText = redoText();
+
+	// Commands that only changed this track disappear from the history
+	for (int i = m_Commands.size() - 1; i >= 0; --i)
+	{
+		Command &command = m_Commands[i];
+		auto it = std::remove_if(command.Tracks.begin(), command.Tracks.end(), [track](const TrackChange &change) { return change.Track == track; });
+		if (it == command.Tracks.end())
+			continue;
+		command.Tracks.erase(it, command.Tracks.end());
+		m_MemoryUsage -= command.MemoryUsage;
+		if (command.Tracks.isEmpty())
+		{
+			m_Commands.removeAt(i);
+			if (i < m_Index)
+				--m_Index;
+		}
+		else
+		{
+			command.MemoryUsage = memoryUsage(command);
+			m_MemoryUsage += command.MemoryUsage;
+		}
+		m_MergeOpen = false;
+	}
+
+	// Forget the track in the command being recorded, the positions of the other tracks shift down
+	for (int i = 0; i < m_Recording.Tracks.size(); ++i)
+	{
+		if (m_Recording.Tracks[i].Track == track)
+		{
+			m_Recording.Tracks.removeAt(i);
+			m_RecordingIds.removeAt(i);
+			m_RecordingTracks.clear();
+			for (int j = 0; j < m_Recording.Tracks.size(); ++j)
+				m_RecordingTracks.insert(m_Recording.Tracks[j].Track, j);
+			break;
+		}
+	}
+
+	historyChanged(index, couldUndo, couldRedo, previousUndoText, previousRedoText);
+}
+
+AnimationUndoJournal::TrackChange &AnimationUndoJournal::recordingTrack(AnimationTrack *track)
+{
+	int index = m_RecordingTracks.value(track, -1);
+	if (index != -1)
+		return m_Recording.Tracks[index];
+
+	m_RecordingTracks.insert(track, m_Recording.Tracks.size());
+	m_RecordingIds.append(QHash<ptrdiff_t, int>());
+	TrackChange change;
+	change.Track = track;
+	change.InterpolationMethodChanged = false;
+	change.InterpolationMethodBefore = track->interpolationMethod();
+	change.InterpolationMethodAfter = track->interpolationMethod();
+	m_Recording.Tracks.append(change);
+	return m_Recording.Tracks.last();
+}
+
+AnimationUndoJournal::KeyframeChange &AnimationUndoJournal::recordingKeyframe(AnimationTrack *track, ptrdiff_t id, bool &added)
+{
+	TrackChange &change = recordingTrack(track);
+	QHash<ptrdiff_t, int> &ids = m_RecordingIds[m_RecordingTracks.value(track)];
+	int index = ids.value(id, -1);
+	added = index == -1;
+	if (!added)
+		return change.Keyframes[index];
+
+	ids.insert(id, change.Keyframes.size());
+	change.Keyframes.append(KeyframeChange());
+	return change.Keyframes.last();
+}
+
+void AnimationUndoJournal::pushCommand(bool merge)
+{
+	int index = m_Index;
+	bool couldUndo = canUndo();
+	bool couldRedo = canRedo();
+	QString previousUndoText = undoText();
+	QString previousRedoText = redoText();
+
+	Command &command = m_Recording;
+	dropUnchanged(command);
+	merge = merge && m_MergeOpen;
+	if (merge && m_MergeIntoLast)
+	{
+		// Merging is closed by anything that changes the history, so the last command is still on top
+		Command &last = m_Commands.last();
+		m_MemoryUsage -= last.MemoryUsage;
+		mergeCommand(last, command);
+		dropUnchanged(last);
+		if (last.Tracks.isEmpty())
+		{
+			m_Commands.removeLast();
+			--m_Index;
+			m_MergeIntoLast = false;
+		}
+		else
+		{
+			last.MemoryUsage = memoryUsage(last);
+			m_MemoryUsage += last.MemoryUsage;
+		}
+	}
+	else if (!command.Tracks.isEmpty())
+	{
+		// A new command discards the commands that were undone
+		while (m_Commands.size() > m_Index)
+			m_MemoryUsage -= m_Commands.takeLast().MemoryUsage;
+		for (TrackChange &change : command.Tracks)
+			change.Keyframes.squeeze();
+		command.MemoryUsage = memoryUsage(command);
+		m_MemoryUsage += command.MemoryUsage;
+		m_Commands.append(command);
+		++m_Index;
+		m_MergeIntoLast = true;
+	}
+	else if (!merge)
+	{
+		// Later steps merging with this empty command start a new one
+		m_MergeIntoLast = false;
+	}
+	m_MergeOpen = true;
+
+	enforceMemoryBudget();
+
+	historyChanged(index, couldUndo, couldRedo, previousUndoText, previousRedoText);
+}
+
+void AnimationUndoJournal::enforceMemoryBudget()
+{
+	// Drop the oldest commands first, then the furthest ones to redo, always keeping one
+	while (m_MemoryUsage > m_MemoryBudget && m_Commands.size() > 1)
+	{
+		if (m_Index > 1)
+		{
+			m_MemoryUsage -= m_Commands.takeFirst().MemoryUsage;
+			--m_Index;
+		}
+		else if (m_Commands.size() > std::max(m_Index, 1))
+		{
+			m_MemoryUsage -= m_Commands.takeLast().MemoryUsage;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void AnimationUndoJournal::historyChanged(int index, bool canUndo, bool canRedo, const QString &undoText, const QString &redoText)
+{
+	if (index != m_Index)
+		emit indexChanged(m_Index);
+	if (canUndo != this->canUndo())
+		emit canUndoChanged(this->canUndo());
+	if (canRedo != this->canRedo())
+		emit canRedoChanged(this->canRedo());
+	if (undoText != this->undoText())
+		emit undoTextChanged(this->undoText());
+	if (redoText != this->redoText())
+		emit redoTextChanged(this->redoText());
+}
+
+void AnimationUndoJournal::mergeCommand(Command &into, const Command &command)
+{
+	for (const TrackChange &change : command.Tracks)
+	{
+		auto it = std::find_if(into.Tracks.begin(), into.Tracks.end(), [&change](const TrackChange &intoChange) { return intoChange.Track == change.Track; });
+		if (it == into.Tracks.end())
+		{
+			into.Tracks.append(change);
+			continue;
+		}
+
+		// Keep the state from before the first command, and take the state after the second
+		TrackChange &intoChange = *it;
+		QHash<ptrdiff_t, int> ids;
+		ids.reserve(intoChange.Keyframes.size());
+		for (int i = 0; i < intoChange.Keyframes.size(); ++i)
+			ids.insert(keyframeId(intoChange.Keyframes[i]), i);
+		for (const KeyframeChange &keyframeChange : change.Keyframes)
+		{
+			int index = ids.value(keyframeId(keyframeChange), -1);
+			if (index != -1)
+				intoChange.Keyframes[index].After = keyframeChange.After;
+			else
+				intoChange.Keyframes.append(keyframeChange);
+		}
+		if (change.InterpolationMethodChanged)
+		{
+			if (!intoChange.InterpolationMethodChanged)
+			{
+				intoChange.InterpolationMethodChanged = true;
+				intoChange.InterpolationMethodBefore = change.InterpolationMethodBefore;
+			}
+			intoChange.InterpolationMethodAfter = change.InterpolationMethodAfter;
+		}
+	}
+}
+
+void AnimationUndoJournal::replay(const TrackChange &change, bool undo)
+{
+	AnimationTrack *track = change.Track;
+	AnimationTrack::EditScope editScope(track);
+
+	if (change.InterpolationMethodChanged)
+		track->setInterpolationMethod(undo ? change.InterpolationMethodBefore : change.InterpolationMethodAfter);
+
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	if (change.Keyframes.size() * ReplayRebuildDivisor <= keyframes.size())
+	{
+		// Remove the keyframes as they are now, then put back their other state, which may take
+		// the time of another keyframe in the change, but not of one outside of it
+		for (const KeyframeChange &keyframeChange : change.Keyframes)
+		{
+			int index = findKeyframe(track, keyframeId(keyframeChange), undo ? keyframeChange.After : keyframeChange.Before);
+			if (index != -1)
+				track->removeKeyframe(keyframes.time(index));
+		}
+		for (const KeyframeChange &keyframeChange : change.Keyframes)
+		{
+			const KeyframeState &to = undo ? keyframeChange.Before : keyframeChange.After;
+			if (to.Present)
+				track->insertKeyframe(to.Time, to.Keyframe);
+		}
+	}
+	else
+	{
+		// Same as above, in one pass over the track
+		QSet<ptrdiff_t> removed;
+		QVector<QPair<double, AnimationKeyframe>> inserted;
+		removed.reserve(change.Keyframes.size());
+		for (const KeyframeChange &keyframeChange : change.Keyframes)
+		{
+			const KeyframeState &to = undo ? keyframeChange.Before : keyframeChange.After;
+			removed.insert(keyframeId(keyframeChange));
+			if (to.Present)
+				inserted.append(qMakePair(to.Time, to.Keyframe));
+		}
+		std::sort(inserted.begin(), inserted.end(), [](const QPair<double, AnimationKeyframe> &a, const QPair<double, AnimationKeyframe> &b) { return a.first < b.first; });
+
+		AnimationKeyframeArray result;
+		result.reserve(keyframes.size());
+		for (int i = 0; i < keyframes.size(); ++i)
+		{
+			if (!removed.contains(keyframes.id(i)))
+				result.append(keyframes.time(i), keyframes.keyframe(i));
+		}
+		AnimationKeyframeArray batch;
+		batch.reserve(inserted.size());
+		for (const QPair<double, AnimationKeyframe> &keyframe : inserted)
+		{
+			if (!batch.isEmpty() && batch.time(batch.size() - 1) == keyframe.first)
+				batch.setKeyframe(batch.size() - 1, keyframe.second);
+			else
+				batch.append(keyframe.first, keyframe.second);
+		}
+		result.merge(batch);
+		track->replaceKeyframes(result);
+	}
+}
+
+void AnimationUndoJournal::dropUnchanged(Command &command)
+{
+	for (TrackChange &change : command.Tracks)
+	{
+		auto it = std::remove_if(change.Keyframes.begin(), change.Keyframes.end(), [](const KeyframeChange &keyframeChange) { return sameState(keyframeChange.Before, keyframeChange.After); });
+		change.Keyframes.erase(it, change.Keyframes.end());
+		if (change.InterpolationMethodBefore == change.InterpolationMethodAfter)
+			change.InterpolationMethodChanged = false;
+	}
+	auto it = std::remove_if(command.Tracks.begin(), command.Tracks.end(), [](const TrackChange &change) { return change.Keyframes.isEmpty() && !change.InterpolationMethodChanged; });
+	command.Tracks.erase(it, command.Tracks.end());
+}
+
+bool AnimationUndoJournal::sameState(const KeyframeState &a, const KeyframeState &b)
+{
+	if (!a.Present || !b.Present)
+		return a.Present == b.Present;
+
+	// The Bezier handles span the whole interpolation data
+	return a.Time == b.Time
+	    && a.Keyframe.Value == b.Keyframe.Value
+	    && a.Keyframe.Interpolation.Bezier.InTangentX == b.Keyframe.Interpolation.Bezier.InTangentX
+	    && a.Keyframe.Interpolation.Bezier.InTangentY == b.Keyframe.Interpolation.Bezier.InTangentY
+	    && a.Keyframe.Interpolation.Bezier.OutTangentX == b.Keyframe.Interpolation.Bezier.OutTangentX
+	    && a.Keyframe.Interpolation.Bezier.OutTangentY == b.Keyframe.Interpolation.Bezier.OutTangentY;
+}
+
+int AnimationUndoJournal::findKeyframe(const AnimationTrack *track, ptrdiff_t id, const KeyframeState &state)
+{
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	if (state.Present)
+	{
+		int index = keyframes.indexOf(state.Time);
+		if (index != -1 && keyframes.id(index) == id)
+			return index;
+	}
+
+	// Keyframes changed outside of a command are not where the history expects them, the index still finds them
+	if (const AnimationKeyframeIndex *index = track->keyframeIndex())
+	{
+		AnimationKeyframeIndex::Location location = index->location(id);
+		if (location.Track == track)
+			return keyframes.indexOf(location.Time);
+	}
+	return -1;
+}
+
+ptrdiff_t AnimationUndoJournal::keyframeId(const KeyframeChange &change)
+{
+	return change.Before.Present ? change.Before.Keyframe.Id : change.After.Keyframe.Id;
+}
+
+qint64 AnimationUndoJournal::memoryUsage(const Command &command)
+{
+	qint64 usage = sizeof(Command) + command.Text.size() * sizeof(QChar);
+	for (const TrackChange &change : command.Tracks)
+		usage += sizeof(TrackChange) + change.Keyframes.size() * sizeof(KeyframeChange);
+	return usage;
+}
+
+/* end of file */
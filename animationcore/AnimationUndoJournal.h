@@ -0,0 +1,200 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationUndoJournal records the edits made to the keyframes of its tracks
+as commands that can be undone and redone. A command only stores the
+keyframes it changed, as they were before and after the command, keyed by
+their ID, so the memory it uses follows the size of the edit rather than
+the size of the tracks.
+
+Tracks report their changes to the journal set with
+AnimationTrack::setUndoJournal while a command is open. Changes made
+outside of a command are not recorded, and leave the history describing
+keyframes that may have moved on since.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_UNDO_JOURNAL__H
+#define ANIMATION_UNDO_JOURNAL__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+#include "AnimationKeyframe.h"
+
+class AnimationTrack;
+
+class ANIMATIONCORE_EXPORT AnimationUndoJournal : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit AnimationUndoJournal(QObject *parent = nullptr);
+
+	// Record the changes made to the tracks until the matching endCommand as one command, calls may be nested
+	// When merging, and the previous command was the last one recorded, the changes are added to it instead,
+	// which is how the steps of a drag become a single command, commands that end up changing nothing are dropped
+	void beginCommand(const QString &text, bool mergeWithPrevious = false);
+	void endCommand();
+	bool isRecording() const;
+
+	// Calls beginCommand on construction and endCommand on destruction
+	class CommandScope
+	{
+	public:
+		inline explicit CommandScope(AnimationUndoJournal *journal, const QString &text, bool mergeWithPrevious = false) : m_Journal(journal) { if (m_Journal) m_Journal->beginCommand(text, mergeWithPrevious); }
+		inline ~CommandScope() { if (m_Journal) m_Journal->endCommand(); }
+
+	private:
+		Q_DISABLE_COPY(CommandScope)
+		AnimationUndoJournal *m_Journal;
+
+	};
+
+	// History
+	bool canUndo() const;
+	bool canRedo() const;
+	QString undoText() const;
+	QString redoText() const;
+	int count() const;
+	int index() const; // Number of commands that can be undone
+	void clear();
+
+	// Approximate memory used by the recorded commands, the oldest commands are dropped to stay within
+	// the budget, except for the last one, the default budget is 64 MiB
+	void setMemoryBudget(qint64 bytes);
+	qint64 memoryBudget() const;
+	qint64 memoryUsage() const;
+
+public slots:
+	void undo();
+	void redo();
+
+signals:
+	void indexChanged(int index);
+	void canUndoChanged(bool canUndo);
+	void canRedoChanged(bool canRedo);
+	void undoTextChanged(const QString &undoText);
+	void redoTextChanged(const QString &redoText);
+
+private:
+	friend AnimationTrack;
+
+	// State of a keyframe on one side of a command
+	struct KeyframeState
+	{
+		bool Present;
+		double Time;
+		AnimationKeyframe Keyframe;
+	};
+
+	struct KeyframeChange
+	{
+		KeyframeState Before;
+		KeyframeState After;
+	};
+
+	struct TrackChange
+	{
+		AnimationTrack *Track;
+		QVector<KeyframeChange> Keyframes;
+		bool InterpolationMethodChanged;
+		AnimationInterpolation InterpolationMethodBefore;
+		AnimationInterpolation InterpolationMethodAfter;
+	};
+
+	struct Command
+	{
+		QString Text;
+		QVector<TrackChange> Tracks;
+		qint64 MemoryUsage;
+	};
+
+	// Called by the tracks while recording, the first report of a keyframe ID in a command
+	// provides its state before the command, and the last one its state after
+	void keyframeRemoved(AnimationTrack *track, double time, const AnimationKeyframe &keyframe);
+	void keyframeInserted(AnimationTrack *track, double time, const AnimationKeyframe &keyframe);
+	void interpolationMethodChanged(AnimationTrack *track, AnimationInterpolation from, AnimationInterpolation to);
+
+	// Called by the tracks when they start or stop reporting to this journal, the history of a track
+	// that is detached or destroyed is dropped from all commands
+	void trackAttached(AnimationTrack *track);
+	void trackDetached(AnimationTrack *track);
+	void trackDestroyed(QObject *track);
+	void dropTrack(const QObject *track);
+
+	TrackChange &recordingTrack(AnimationTrack *track);
+	KeyframeChange &recordingKeyframe(AnimationTrack *track, ptrdiff_t id, bool &added);
+	void pushCommand(bool merge);
+	void enforceMemoryBudget();
+
+	// Signals for the history having changed from the given state
+	void historyChanged(int index, bool canUndo, bool canRedo, const QString &undoText, const QString &redoText);
+
+	static void mergeCommand(Command &into, const Command &command);
+	static void replay(const TrackChange &change, bool undo);
+	static void dropUnchanged(Command &command);
+	static bool sameState(const KeyframeState &a, const KeyframeState &b);
+	static ptrdiff_t keyframeId(const KeyframeChange &change);
+	static int findKeyframe(const AnimationTrack *track, ptrdiff_t id, const KeyframeState &state);
+	static qint64 memoryUsage(const Command &command);
+
+	// Commands in the order they were recorded, the first m_Index can be undone, the rest redone
+	QList<Command> m_Commands;
+	int m_Index;
+	qint64 m_MemoryUsage;
+	qint64 m_MemoryBudget;
+
+	// Command being recorded, with the position of every track in it, and of every keyframe ID per track
+	int m_RecordDepth;
+	bool m_RecordMerge;
+	Command m_Recording;
+	QHash<AnimationTrack *, int> m_RecordingTracks;
+	QVector<QHash<ptrdiff_t, int>> m_RecordingIds;
+
+	// Merging is open from the end of a command until the history is otherwise changed,
+	// the last command is the one to merge into, unless the command to merge with was dropped
+	bool m_MergeOpen;
+	bool m_MergeIntoLast;
+
+}; /* class AnimationUndoJournal */
+
+#endif /* ANIMATION_UNDO_JOURNAL__H */
+
+/* end of file */
@@ -0,0 +1,447 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+#include "AnimationVectorTrack.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cstring>
+
+#include "AnimationTrack.h"
+
+AnimationVectorTrack::AnimationVectorTrack(int channelCount)
+    : m_ChannelCount(std::max(channelCount, 1))
+    , m_InterpolationMethod(AnimationInterpolation::Linear)
+    , m_SegmentCursor(-1)
+{
+}
+
+AnimationVectorTrack AnimationVectorTrack::fromTracks(const AnimationTrack *const *tracks, int channelCount)
+{
+	AnimationVectorTrack res(channelCount);
+	if (channelCount <= 0)
+		return res;
+	res.m_InterpolationMethod = tracks[0]->interpolationMethod();
+
+	// Union of the keyframe times of all the channels
+	QVector<double> times;
+	for (int channel = 0; channel < channelCount; ++channel)
+	{
+		const AnimationKeyframeArray &keyframes = tracks[channel]->keyframeArray();
+		for (int i = 0; i < keyframes.size(); ++i)
+			times.append(keyframes.time(i));
+	}
+	std::sort(times.begin(), times.end());
+	times.erase(std::unique(times.begin(), times.end()), times.end());
+
+	// The times are sorted, so every keyframe is appended
+	res.reserve(times.size());
+	QVarLengthArray<AnimationKeyframe, 4> keyframes(channelCount);
+	for (double time : times)
+	{
+		for (int channel = 0; channel < channelCount; ++channel)
+		{
+			const AnimationKeyframeArray &source = tracks[channel]->keyframeArray();
+			int index = source.indexOf(time);
+			if (index != -1)
+			{
+				keyframes[channel] = source.keyframe(index);
+			}
+			else
+			{
+				keyframes[channel] = AnimationKeyframe();
+				keyframes[channel].Value = tracks[channel]->valueAtTime(time);
+			}
+		}
+		res.insert(time, AnimationKeyframe::s_NextId++, keyframes.constData());
+	}
+	return res;
+}
+
+AnimationKeyframe AnimationVectorTrack::keyframe(int index, int channel) const
+{
+	int element = index * m_ChannelCount + channel;
+	AnimationKeyframe res;
+	res.Id = m_Ids[index];
+	res.Value = m_Values[element];
+	double parameters[AnimationKeyframeArray::ParameterCount];
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		parameters[slot] = m_Parameters[slot][element];
+	memcpy(&res.Interpolation, parameters, sizeof(parameters));
+	return res;
+}
+
+int AnimationVectorTrack::indexOf(double time) const
+{
+	int index = static_cast<int>(std::lower_bound(m_Times.constBegin(), m_Times.constEnd(), time) - m_Times.constBegin());
+	if (index < m_Times.size() && m_Times[index] == time)
+		return index;
+	return -1;
+}
+
+void AnimationVectorTrack::setInterpolationMethod(AnimationInterpolation interpolationMethod)
+{
+	if (m_InterpolationMethod != interpolationMethod)
+	{
+		m_InterpolationMethod = interpolationMethod;
+		invalidateAllSegments();
+	}
+}
+
+void AnimationVectorTrack::reserve(int size)
+{
+	m_Times.reserve(size);
+	m_Ids.reserve(size);
+	m_Values.reserve(size * m_ChannelCount);
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		m_Parameters[slot].reserve(size * m_ChannelCount);
+}
+
+void AnimationVectorTrack::clear()
+{
+	m_Times.clear();
+	m_Ids.clear();
+	m_Values.clear();
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		m_Parameters[slot].clear();
+	invalidateAllSegments();
+}
+
+int AnimationVectorTrack::upsertKeyframe(double time, const AnimationKeyframe *keyframes)
+{
+	return insert(time, AnimationKeyframe::s_NextId++, keyframes);
+}
+
+int AnimationVectorTrack::upsertKeyframe(double time, const double *values)
+{
+	QVarLengthArray<AnimationKeyframe, 4> keyframes(m_ChannelCount);
+	for (int channel = 0; channel < m_ChannelCount; ++channel)
+		keyframes[channel].Value = values[channel];
+	return insert(time, AnimationKeyframe::s_NextId++, keyframes.constData());
+}
+
+void AnimationVectorTrack::setKeyframe(int index, int channel, const AnimationKeyframe &keyframe)
+{
+	setChannel(index, channel, keyframe);
+	invalidateSegments(index - 1, index + 1);
+}
+
+void AnimationVectorTrack::removeKeyframe(double time)
+{
+	int index = indexOf(time);
+	if (index == -1)
+		return;
+
+	int n = m_ChannelCount;
+	m_Times.remove(index);
+	m_Ids.remove(index);
+	m_Values.remove(index * n, n);
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		m_Parameters[slot].remove(index * n, n);
+	keyframeRemoved(index);
+}
+
+int AnimationVectorTrack::moveKeyframe(double fromTime, double toTime)
+{
+	int index = indexOf(fromTime);
+	if (index == -1 || fromTime == toTime)
+		return index;
+
+	// Take the keyframe out and insert it again, keeping its ID
+	QVarLengthArray<AnimationKeyframe, 4> keyframes(m_ChannelCount);
+	for (int channel = 0; channel < m_ChannelCount; ++channel)
+		keyframes[channel] = keyframe(index, channel);
+	ptrdiff_t id = m_Ids[index];
+	removeKeyframe(fromTime);
+	return insert(toTime, id, keyframes.constData());
+}
+
+int AnimationVectorTrack::insert(double time, ptrdiff_t id, const AnimationKeyframe *keyframes)
+{
+	int n = m_ChannelCount;
+	int index = static_cast<int>(std::lower_bound(m_Times.constBegin(), m_Times.constEnd(), time) - m_Times.constBegin());
+	if (index == m_Times.size() || m_Times[index] != time)
+	{
+		// Make room for the new keyframe
+		m_Times.insert(index, time);
+		m_Ids.insert(index, id);
+		m_Values.insert(index * n, n, 0.0);
+		for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+			m_Parameters[slot].insert(index * n, n, 0.0);
+		keyframeInserted(index);
+	}
+	else
+	{
+		m_Ids[index] = id;
+		invalidateSegments(index - 1, index + 1);
+	}
+	for (int channel = 0; channel < n; ++channel)
+		setChannel(index, channel, keyframes[channel]);
+	return index;
+}
+
+void AnimationVectorTrack::setChannel(int index, int channel, const AnimationKeyframe &keyframe)
+{
+	int element = index * m_ChannelCount + channel;
+	double parameters[AnimationKeyframeArray::ParameterCount];
+	memcpy(parameters, &keyframe.Interpolation, sizeof(parameters));
+	m_Values[element] = keyframe.Value;
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		m_Parameters[slot][element] = parameters[slot];
+}
+
+void AnimationVectorTrack::valueAtTime(double time, double *out) const
+{
+	int n = m_ChannelCount;
+	int size = m_Times.size();
+	if (size == 0)
+	{
+		std::fill(out, out + n, 0.0);
+		return;
+	}
+	if (time <= m_Times[0])
+	{
+		std::copy(m_Values.constData(), m_Values.constData() + n, out);
+		return;
+	}
+	if (time >= m_Times[size - 1])
+	{
+		std::copy(m_Values.constData() + (size - 1) * n, m_Values.constData() + size * n, out);
+		return;
+	}
+
+	updateSegments();
+	int index = animationSegmentAt(m_Times.constData(), size, time, m_SegmentCursor);
+	m_SegmentCursor = index;
+	dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) {
+		evaluateSegment<decltype(evaluator)::Interpolation>(index, time, out);
+	});
+}
+
+void AnimationVectorTrack::sampleRange(double fromTime, double timeStep, size_t count, double *out) const
+{
+	int n = m_ChannelCount;
+	if (timeStep < 0.0 && count > 1)
+	{
+		// Walk the segments forward and reverse the samples
+		sampleRange(fromTime + timeStep * (count - 1), -timeStep, count, out);
+		for (size_t i = 0, j = count - 1; i < j; ++i, --j)
+			std::swap_ranges(out + i * n, out + (i + 1) * n, out + j * n);
+		return;
+	}
+
+	int size = m_Times.size();
+	if (size == 0)
+	{
+		std::fill(out, out + count * n, 0.0);
+		return;
+	}
+
+	updateSegments();
+	const double *times = m_Times.constData();
+
+	// Samples before the first keyframe
+	size_t i = 0;
+	for (; i < count && fromTime + i * timeStep <= times[0]; ++i)
+		std::copy(m_Values.constData(), m_Values.constData() + n, out + i * n);
+
+	// One segment search serves all the channels of the samples within it
+	if (i < count)
+	{
+		dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) {
+			int index = animationSegmentAt(times, size, fromTime + i * timeStep, -1);
+			while (i < count && index < size - 1)
+			{
+				double time1 = times[index + 1];
+				for (; i < count && fromTime + i * timeStep < time1; ++i)
+					evaluateSegment<decltype(evaluator)::Interpolation>(index, fromTime + i * timeStep, out + i * n);
+
+				// Skip ahead with a search when there are many keyframes between two samples
+				double nextTime = fromTime + i * timeStep;
+				if (i < count && index + 2 < size && nextTime >= times[index + 2])
+					index = static_cast<int>(std::upper_bound(times, times + size, nextTime) - times) - 1;
+				else
+					++index;
+			}
+		});
+	}
+
+	// Samples after the last keyframe
+	for (; i < count; ++i)
+		std::copy(m_Values.constData() + (size - 1) * n, m_Values.constData() + size * n, out + i * n);
+}
+
+template <AnimationInterpolation Method>
+void AnimationVectorTrack::evaluateSegment(int index, double time, double *out) const
+{
+	int n = m_ChannelCount;
+	const double *c = m_Coefficients.constData() + static_cast<size_t>(index) * 4 * n;
+	if constexpr (Method == AnimationInterpolation::Step)
+	{
+		std::copy(c, c + n, out);
+	}
+	else if constexpr (Method == AnimationInterpolation::Bezier)
+	{
+		// The handles of each channel map the time to a different curve parameter, so every channel is solved separately
+		typedef AnimationEvaluator<AnimationInterpolation::Bezier> Evaluator;
+		Evaluator::Segment segment;
+		segment.Time = m_Times[index];
+		segment.InvDuration = m_InvDurations[index];
+		const AnimationBezierTiming<double> *timings = m_Timings.constData() + static_cast<size_t>(index) * n;
+		for (int channel = 0; channel < n; ++channel)
+		{
+			segment.C0 = c[channel];
+			segment.C1 = c[n + channel];
+			segment.C2 = c[2 * n + channel];
+			segment.C3 = c[3 * n + channel];
+			out[channel] = Evaluator::evaluate(segment, timings + channel, time, true);
+		}
+	}
+	else
+	{
+		// All the channels share the normalized time, evaluate them side by side
+		double u = (time - m_Times[index]) * m_InvDurations[index];
+		int channel = 0;
+#ifdef ANIMATION_EVALUATOR_SSE2
+		typedef AnimationEvaluatorLanes<double> Lanes;
+		const Lanes::Vector uu = Lanes::set(u);
+		for (; channel + Lanes::Width <= n; channel += Lanes::Width)
+		{
+			Lanes::Vector v;
+			if constexpr (Method == AnimationInterpolation::Linear)
+			{
+				v = Lanes::add(Lanes::load(c + channel), Lanes::mul(uu, Lanes::load(c + n + channel)));
+			}
+			else
+			{
+				v = Lanes::add(Lanes::load(c + 2 * n + channel), Lanes::mul(uu, Lanes::load(c + 3 * n + channel)));
+				v = Lanes::add(Lanes::load(c + n + channel), Lanes::mul(uu, v));
+				v = Lanes::add(Lanes::load(c + channel), Lanes::mul(uu, v));
+			}
+			Lanes::store(out + channel, v);
+		}
+#endif
+		for (; channel < n; ++channel)
+		{
+			if constexpr (Method == AnimationInterpolation::Linear)
+				out[channel] = c[channel] + u * c[n + channel];
+			else
+				out[channel] = c[channel] + u * (c[n + channel] + u * (c[2 * n + channel] + u * c[3 * n + channel]));
+		}
+	}
+}
+
+void AnimationVectorTrack::updateSegments() const
+{
+	if (!m_DirtySegments.isDirty())
+		return;
+
+	int n = m_ChannelCount;
+	const double *times = m_Times.constData();
+	dispatchAnimationEvaluator(m_InterpolationMethod, [&](auto evaluator) {
+		for (int i = m_DirtySegments.From; i < m_DirtySegments.To; ++i)
+		{
+			m_InvDurations[i] = 1.0 / (times[i + 1] - times[i]);
+			double *c = m_Coefficients.data() + static_cast<size_t>(i) * 4 * n;
+			for (int channel = 0; channel < n; ++channel)
+			{
+				AnimationKeyframe k0 = keyframe(i, channel);
+				AnimationKeyframe k1 = keyframe(i + 1, channel);
+				AnimationCurveSegment<double> segment = evaluator.segment(times[i], k0, times[i + 1], k1);
+				c[channel] = segment.C0;
+				c[n + channel] = segment.C1;
+				c[2 * n + channel] = segment.C2;
+				c[3 * n + channel] = segment.C3;
+				if (evaluator.Interpolation == AnimationInterpolation::Bezier)
+					m_Timings[i * n + channel] = evaluator.timing(times[i], k0, times[i + 1], k1, true);
+			}
+		}
+	});
+	m_DirtySegments.clear();
+}
+
+void AnimationVectorTrack::invalidateSegments(int from, int to) const
+{
+	m_DirtySegments.invalidate(from, to, m_InvDurations.size());
+}
+
+void AnimationVectorTrack::invalidateAllSegments() const
+{
+	int count = std::max(static_cast<int>(m_Times.size()) - 1, 0);
+	m_InvDurations.resize(count);
+	m_Coefficients.resize(count * 4 * m_ChannelCount);
+	if (m_InterpolationMethod == AnimationInterpolation::Bezier)
+		m_Timings.resize(count * m_ChannelCount);
+	else
+		m_Timings.clear();
+	m_DirtySegments.invalidateAll(count);
+}
+
+void AnimationVectorTrack::keyframeInserted(int index) const
+{
+	int n = m_ChannelCount;
+	int first = m_DirtySegments.keyframesInserted(index, index, 1, m_Times.size(), m_InvDurations.size(), 1, [&](int segment, int added) {
+		m_InvDurations.insert(segment, added, 0.0);
+		m_Coefficients.insert(segment * 4 * n, added * 4 * n, 0.0);
+		if (m_InterpolationMethod == AnimationInterpolation::Bezier)
+			m_Timings.insert(segment * n, added * n, AnimationBezierTiming<double>());
+	});
+	if (first < 0)
+		invalidateAllSegments();
+}
+
+void AnimationVectorTrack::keyframeRemoved(int index) const
+{
+	int n = m_ChannelCount;
+	int first = m_DirtySegments.keyframeRemoved(index, m_Times.size(), m_InvDurations.size(), 1, [&](int segment) {
+		m_InvDurations.remove(segment);
+		m_Coefficients.remove(segment * 4 * n, 4 * n);
+		if (m_InterpolationMethod == AnimationInterpolation::Bezier)
+			m_Timings.remove(segment * n, n);
+	});
+	if (first < 0)
+		invalidateAllSegments();
+}
+
+size_t AnimationVectorTrack::memoryUsage() const
+{
+	size_t res = m_Times.capacity() * sizeof(double);
+	res += m_Ids.capacity() * sizeof(ptrdiff_t);
+	res += m_Values.capacity() * sizeof(double);
+	for (int slot = 0; slot < AnimationKeyframeArray::ParameterCount; ++slot)
+		res += m_Parameters[slot].capacity() * sizeof(double);
+	res += m_InvDurations.capacity() * sizeof(double);
+	res += m_Coefficients.capacity() * sizeof(double);
+	res += m_Timings.capacity() * sizeof(AnimationBezierTiming<double>);
+	return res;
+}
+
+/* end of file */
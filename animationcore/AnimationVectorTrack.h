@@ -0,0 +1,143 @@
+/*
+
+Copyright (C) 2023  Jan BOON (Kaetemi) <jan.boon@kaetemi.be>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+3. Neither the name of the copyright holder nor the names of its contributors
+   may be used to endorse or promote products derived from this software
+   without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+This library contains code that was generated using ChatGPT and Copilot.
+
+*/
+
+/*
+
+AnimationVectorTrack animates several channels together, such as the
+components of a position or a color, on one shared time axis. Every keyframe
+holds a value and interpolation parameters for each channel under a single
+ID, so the keys of the components stay aligned. Evaluation locates the
+segment once for all channels, and evaluates the segment polynomials of the
+channels together, which are stored next to each other for this purpose.
+
+All channels use the same interpolation method. The cached segments are
+rebuilt by the first evaluation after an edit, as with AnimationTrack, so
+evaluation is not safe to call concurrently with edits, or on a track that
+was edited and not evaluated since.
+
+*/
+
+#pragma once
+#ifndef ANIMATION_VECTOR_TRACK__H
+#define ANIMATION_VECTOR_TRACK__H
+
+#include "AnimationCoreGlobal.h"
+
+#include <QVector>
+
+#include "AnimationKeyframe.h"
+#include "AnimationEvaluator.h"
+#include "AnimationKeyframeArray.h"
+#include "AnimationSegmentCache.h"
+
+class AnimationTrack;
+
+class ANIMATIONCORE_EXPORT AnimationVectorTrack
+{
+public:
+	explicit AnimationVectorTrack(int channelCount = 3);
+
+	// Combine separate tracks into the channels of one track, the first track sets the interpolation method
+	// Channels get a keyframe on their own curve at the times where only other channels had one, which
+	// keeps the curves unchanged with Step and Linear interpolation
+	static AnimationVectorTrack fromTracks(const AnimationTrack *const *tracks, int channelCount);
+
+	// Getters
+	int channelCount() const { return m_ChannelCount; }
+	int size() const { return m_Times.size(); }
+	bool isEmpty() const { return m_Times.isEmpty(); }
+	AnimationInterpolation interpolationMethod() const { return m_InterpolationMethod; }
+	const double *times() const { return m_Times.constData(); }
+	double time(int index) const { return m_Times[index]; }
+	ptrdiff_t id(int index) const { return m_Ids[index]; }
+	double value(int index, int channel) const { return m_Values[index * m_ChannelCount + channel]; }
+	AnimationKeyframe keyframe(int index, int channel) const; // Carries the ID of the keyframe
+	int indexOf(double time) const; // Exact match, or -1
+
+	// Setters
+	void setInterpolationMethod(AnimationInterpolation interpolationMethod);
+	void reserve(int size);
+	void clear();
+
+	// Keyframe manipulation, keyframes and values point to one entry per channel
+	// The upsert functions assign a new ID, and replace any keyframe at the same time, returning its index
+	int upsertKeyframe(double time, const AnimationKeyframe *keyframes);
+	int upsertKeyframe(double time, const double *values);
+	void setKeyframe(int index, int channel, const AnimationKeyframe &keyframe);
+	void removeKeyframe(double time);
+	int moveKeyframe(double fromTime, double toTime); // Replaces any other keyframe at the destination time
+
+	// Evaluation, writing one value per channel for every sample, clamped to the first and last keyframe
+	// The single time version also caches the last segment it located for the next call
+	void valueAtTime(double time, double *out) const;
+	void sampleRange(double fromTime, double timeStep, size_t count, double *out) const;
+
+	// Approximate heap memory used, including the cached segments
+	size_t memoryUsage() const;
+
+private:
+	int insert(double time, ptrdiff_t id, const AnimationKeyframe *keyframes);
+	void setChannel(int index, int channel, const AnimationKeyframe &keyframe);
+
+	int m_ChannelCount;
+	AnimationInterpolation m_InterpolationMethod;
+
+	// Keyframe i holds m_Values[i * m_ChannelCount + channel], and the same for every parameter slot
+	QVector<double> m_Times;
+	QVector<ptrdiff_t> m_Ids;
+	QVector<double> m_Values;
+	QVector<double> m_Parameters[AnimationKeyframeArray::ParameterCount];
+
+	// Cached segments, segment i spans keyframes i and i + 1, and stores the polynomial coefficients
+	// of all channels by degree, C0 of every channel, then C1, C2 and C3, at m_Coefficients[i * 4 * m_ChannelCount]
+	// Segments in the dirty range are rebuilt on the next evaluation
+	mutable QVector<double> m_InvDurations;
+	mutable QVector<double> m_Coefficients;
+	mutable QVector<AnimationBezierTiming<double>> m_Timings; // Bezier only, m_Timings[i * m_ChannelCount + channel]
+	mutable AnimationSegmentCacheRange m_DirtySegments;
+
+	// Index of the last segment evaluated by valueAtTime, validated against the keyframe times on use
+	mutable int m_SegmentCursor;
+
+	void updateSegments() const;
+	void invalidateSegments(int from, int to) const;
+	void invalidateAllSegments() const;
+	void keyframeInserted(int index) const;
+	void keyframeRemoved(int index) const;
+
+	template <AnimationInterpolation Method>
+	void evaluateSegment(int index, double time, double *out) const;
+
+}; /* class AnimationVectorTrack */
+
+#endif /* ANIMATION_VECTOR_TRACK__H */
+
+/* end of file */
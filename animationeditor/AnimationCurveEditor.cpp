@@ -39,6 +39,8 @@ This library contains code that was generated using ChatGPT and Copilot.
 #include <QMenu>
 #include <QAction>
 #include <QStyleOption>
+#include <algorithm>
+#include <cmath>
 
 #include "AnimationTimelineEditor.h" // AnimationContextMenu
 
@@ -79,8 +81,29 @@ void AnimationCurveEditor::createContextMenu()
 
 void AnimationCurveEditor::setAnimationTracks(const QList<AnimationTrack *> &tracks)
 {
+	for (AnimationTrack *track : m_AnimationTracks)
+		disconnect(track, nullptr, this, nullptr);
+
 	m_AnimationTracks = tracks;
-	update();
+
+	// Drop the painted curves of the tracks that left, before their address can be reused
+	for (QHash<const AnimationTrack *, CurveCache>::iterator it = m_CurveCache.begin(); it != m_CurveCache.end();)
+	{
+		if (m_AnimationTracks.contains(const_cast<AnimationTrack *>(it.key())))
+			++it;
+		else
+			it = m_CurveCache.erase(it);
+	}
+
+	// Follow changes made to the tracks from elsewhere
+	for (AnimationTrack *track : m_AnimationTracks)
+	{
+		connect(track, &AnimationTrack::keyframesRangeChanged, this, &AnimationCurveEditor::onKeyframesRangeChanged);
+		connect(track, &AnimationTrack::interpolationMethodChanged, this, &AnimationCurveEditor::invalidateCurveLayer);
+		connect(track, &AnimationTrack::colorChanged, this, &AnimationCurveEditor::invalidateCurveLayer);
+	}
+
+	invalidateCurveLayer();
 }
 
 const QList<AnimationTrack *> &AnimationCurveEditor::animationTracks() const
@@ -99,6 +122,16 @@ QSet<ptrdiff_t> AnimationCurveEditor::keyframeSelection() const
 	return m_SelectedKeyframes;
 }
 
+void AnimationCurveEditor::setUndoJournal(AnimationUndoJournal *journal)
+{
+	m_UndoJournal = journal;
+}
+
+void AnimationCurveEditor::setKeyframeIndex(AnimationKeyframeIndex *index)
+{
+	m_KeyframeIndex = index;
+}
+
 void AnimationCurveEditor::updateMousePosition(const QPoint &pos, bool ctrlHeld)
 {
 	m_MouseMovePosition = pos;
@@ -181,57 +214,34 @@ void AnimationCurveEditor::updateMousePosition(const QPoint &pos, bool ctrlHeld)
 				double timeDelta = timeAtX(pos.x()) - timeAtX(m_MouseLeftPressPosition.x());
 				double valueDelta = -(pos.y() - m_MouseLeftPressPosition.y()) / m_VerticalPixelPerValue;
 
-				// Move the selected keyframes or handles relative to the backup position
-				for (int i = 0; i < m_AnimationTracks.size(); ++i)
+				// Move the selected keyframes or handles relative to where they were when the drag started
+				// Every step of the drag is merged into the command recorded by the first one
+				bool firstStep = !m_DragSession.isActive();
+				if (firstStep)
 				{
-					AnimationTrack *track = m_AnimationTracks[i];
-					AnimationTrack::KeyframeMap &originalKeyframes = m_BackupAnimationTracks[i];
-
-					// Restore the original tracks before modifying keyframes
-					track->m_Keyframes = originalKeyframes;
-					bool changed = false;
-
-					for (AnimationTrack::KeyframeMap::const_iterator it = originalKeyframes.begin(); it != originalKeyframes.end(); ++it)
+					AnimationDragSession::Target target = AnimationDragSession::Target::OutHandles;
+					const QSet<ptrdiff_t> *selection = &m_SelectedRightInterpolationHandles;
+					if (m_InteractionState == InteractionState::MoveOnly || m_InteractionState == InteractionState::SelectMove)
 					{
-						if (m_InteractionState == InteractionState::MoveOnly || m_InteractionState == InteractionState::SelectMove)
-						{
-							if (m_SelectedKeyframes.contains(it.value().Id))
-							{
-								double newTime = it.key() + timeDelta;
-								double newValue = it.value().Value + valueDelta;
-								AnimationKeyframe keyframe = track->m_Keyframes.value(it.key());
-								keyframe.Value = newValue;
-								track->m_Keyframes.remove(it.key());
-								track->m_Keyframes.insert(newTime, keyframe);
-								changed = true;
-							}
-						}
-						else if (m_InteractionState == InteractionState::MoveLeftHandleOnly || m_InteractionState == InteractionState::SelectMoveLeftHandle)
-						{
-							if (m_SelectedLeftInterpolationHandles.contains(it.value().Id))
-							{
-								AnimationKeyframe &keyframe = track->m_Keyframes[it.key()];
-								keyframe.Interpolation.Bezier.InTangentX += timeDelta;
-								keyframe.Interpolation.Bezier.InTangentY += valueDelta;
-							}
-						}
-						else if (m_InteractionState == InteractionState::MoveRightHandleOnly || m_InteractionState == InteractionState::SelectMoveRightHandle)
-						{
-							if (m_SelectedRightInterpolationHandles.contains(it.value().Id))
-							{
-								AnimationKeyframe &keyframe = track->m_Keyframes[it.key()];
-								keyframe.Interpolation.Bezier.OutTangentX += timeDelta;
-								keyframe.Interpolation.Bezier.OutTangentY += valueDelta;
-								changed = true;
-							}
-						}
+						target = AnimationDragSession::Target::Keyframes;
+						selection = &m_SelectedKeyframes;
 					}
-
-					if (changed)
+					else if (m_InteractionState == InteractionState::MoveLeftHandleOnly || m_InteractionState == InteractionState::SelectMoveLeftHandle)
 					{
-						emit trackChanged(track);
+						target = AnimationDragSession::Target::InHandles;
+						selection = &m_SelectedLeftInterpolationHandles;
 					}
+					if (m_KeyframeIndex)
+						m_DragSession.begin(*m_KeyframeIndex, *selection, target);
+					else
+						m_DragSession.begin(m_AnimationTracks, *selection, target);
 				}
+				{
+					AnimationUndoJournal::CommandScope command(m_UndoJournal, m_DragSession.target() == AnimationDragSession::Target::Keyframes ? tr("Move Keyframes") : tr("Move Handles"), !firstStep);
+					m_DragSession.apply(timeDelta, valueDelta);
+				}
+				for (AnimationTrack *track : m_DragSession.tracks())
+					emit trackChanged(track);
 			}
 		}
 		else if (m_InteractionState == InteractionState::MultiSelect)
@@ -271,13 +281,14 @@ void AnimationCurveEditor::updateMouseSelection(bool ctrlHeld)
 
 void AnimationCurveEditor::restoreAnimationTracks()
 {
-	for (int i = 0; i < m_AnimationTracks.size(); ++i)
+	// Merged into the command of the drag, which then changes nothing and is dropped
+	QList<AnimationTrack *> tracks = m_DragSession.tracks();
 	{
-		AnimationTrack *track = m_AnimationTracks[i];
-		AnimationTrack::KeyframeMap &originalKeyframes = m_BackupAnimationTracks[i];
-		track->setKeyframes(originalKeyframes);
-		emit trackChanged(track);
+		AnimationUndoJournal::CommandScope command(m_UndoJournal, QString(), true);
+		m_DragSession.revert();
 	}
+	for (AnimationTrack *track : tracks)
+		emit trackChanged(track);
 }
 
 void AnimationCurveEditor::mousePressEvent(QMouseEvent *event)
@@ -298,15 +309,6 @@ void AnimationCurveEditor::mousePressEvent(QMouseEvent *event)
 		m_ActiveLeftInterpolationHandle = leftHandle;
 		m_ActiveRightInterpolationHandle = rightHandle;
 		m_ActiveTrack = m_HoverTrack;
-		if (keyframe != -1 || leftHandle != -1 || rightHandle != -1)
-		{
-			// Backup all tracks before modifying keyframes
-			m_BackupAnimationTracks.clear();
-			for (const AnimationTrack *track : m_AnimationTracks)
-			{
-				m_BackupAnimationTracks.append(track->keyframes());
-			}
-		}
 		if (keyframe != -1)
 		{
 			if (m_SelectedKeyframes.contains(keyframe))
@@ -509,12 +511,7 @@ void AnimationCurveEditor::mouseReleaseEvent(QMouseEvent *event)
 
 	if (event->button() == Qt::LeftButton)
 	{
-		if (m_InteractionState == InteractionState::MoveOnly || m_InteractionState == InteractionState::SelectMove)
-		{
-			// Apply the move operation to selected keyframes
-			m_BackupAnimationTracks.clear();
-		}
-		else if (m_InteractionState == InteractionState::MultiSelect)
+		if (m_InteractionState == InteractionState::MultiSelect)
 		{
 			// Finalize the multi-selection
 			m_BackupSelectedKeyframes.clear();
@@ -522,6 +519,9 @@ void AnimationCurveEditor::mouseReleaseEvent(QMouseEvent *event)
 			m_BackupSelectedRightInterpolationHandles.clear();
 		}
 
+		// Keep the moved keyframes or handles
+		m_DragSession.commit();
+
 		m_InteractionState = InteractionState::None;
 		m_MouseLeftPressPosition = QPoint();
 		m_MouseLeftPressTimeValue = QPointF();
@@ -725,24 +725,24 @@ ptrdiff_t AnimationCurveEditor::keyframeAtPosition(const QPoint &pos, AnimationT
 	{
 		--trackIt;
 		AnimationTrack *track = *trackIt;
-		const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
-		if (keyframes.begin() != keyframes.end())
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
+		if (!keyframes.isEmpty())
 		{
 			// Check if the pos time is between the first and last keyframe
-			double firstTime = keyframes.begin().key();
-			double lastTime = std::prev(keyframes.end()).key();
+			double firstTime = keyframes.time(0);
+			double lastTime = keyframes.time(keyframes.size() - 1);
 			if (timeAtX(pos.x() + keyframeHalfSize) >= firstTime && timeAtX(pos.x() - keyframeHalfSize) <= lastTime)
 			{
-				// Find the keyframe at the given position
-				for (AnimationTrack::KeyframeMap::const_iterator it = keyframes.constEnd(); it != keyframes.constBegin();)
+				// Find the keyframe at the given position, among the keyframes within the marker size horizontally
+				int from = keyframes.lowerBound(timeAtX(pos.x() - keyframeHalfSize - 1));
+				for (int i = keyframes.upperBound(timeAtX(pos.x() + keyframeHalfSize + 1)) - 1; i >= from; --i)
 				{
-					--it;
-					QPoint keyframePos = keyframePoint(it.key(), it.value().Value);
+					QPoint keyframePos = keyframePoint(keyframes.time(i), keyframes.value(i));
 					if (abs(keyframePos.x() - pos.x()) <= keyframeHalfSize && abs(keyframePos.y() - pos.y()) <= keyframeHalfSize)
 					{
 						if (trackRes)
 							*trackRes = track;
-						return it.value().Id;
+						return keyframes.id(i);
 					}
 				}
 			}
@@ -765,8 +765,8 @@ ptrdiff_t AnimationCurveEditor::leftHandleAtPosition(const QPoint &pos, Animatio
 		AnimationTrack *track = *trackIt;
 		if (track->interpolationMethod() == AnimationInterpolation::Bezier)
 		{
-			const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
-			if (keyframes.begin() != keyframes.end())
+			const AnimationKeyframeArray &keyframes = track->keyframeArray();
+			if (!keyframes.isEmpty())
 			{
 				// Check if the pos time is between the first and last keyframe (not entirely accurate on the rounding)
 				// double firstTime = keyframes.begin().key() - keyframes.begin().value().Interpolation.Bezier.InTangentX;
@@ -774,20 +774,19 @@ ptrdiff_t AnimationCurveEditor::leftHandleAtPosition(const QPoint &pos, Animatio
 				// if (timeAtX(pos.x() + handleHalfSize) >= firstTime && timeAtX(pos.x() - handleHalfSize) <= lastTime)
 				{
 					// Find the keyframe at the given position
-					for (AnimationTrack::KeyframeMap::const_iterator it = keyframes.constEnd(); it != keyframes.constBegin();)
+					for (int i = keyframes.size() - 1; i >= 0; --i)
 					{
-						--it;
-						QPoint keyframePos = keyframePoint(it.key(), it.value().Value);
+						QPoint keyframePos = keyframePoint(keyframes.time(i), keyframes.value(i));
 						const double scale = 1.0;
 						QPoint handleOffset = keyframePointOffset(
-						    it.value().Interpolation.Bezier.InTangentX * scale,
-						    -it.value().Interpolation.Bezier.InTangentY * scale);
+						    keyframes.parameter(AnimationKeyframeArray::InTangentX, i) * scale,
+						    -keyframes.parameter(AnimationKeyframeArray::InTangentY, i) * scale);
 						QPoint handlePoint = keyframePos + handleOffset;
 						if (abs(handlePoint.x() - pos.x()) <= handleHalfSize && abs(handlePoint.y() - pos.y()) <= handleHalfSize)
 						{
 							if (trackRes)
 								*trackRes = track;
-							return it.value().Id;
+							return keyframes.id(i);
 						}
 					}
 				}
@@ -811,8 +810,8 @@ ptrdiff_t AnimationCurveEditor::rightHandleAtPosition(const QPoint &pos, Animati
 		AnimationTrack *track = *trackIt;
 		if (track->interpolationMethod() == AnimationInterpolation::Bezier)
 		{
-			const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
-			if (keyframes.begin() != keyframes.end())
+			const AnimationKeyframeArray &keyframes = track->keyframeArray();
+			if (!keyframes.isEmpty())
 			{
 				// Check if the pos time is between the first and last keyframe (not entirely accurate on the rounding)
 				// double firstTime = keyframes.begin().key() - keyframes.begin().value().Interpolation.Bezier.InTangentX;
@@ -820,20 +819,19 @@ ptrdiff_t AnimationCurveEditor::rightHandleAtPosition(const QPoint &pos, Animati
 				// if (timeAtX(pos.x() + handleHalfSize) >= firstTime && timeAtX(pos.x() - handleHalfSize) <= lastTime)
 				{
 					// Find the keyframe at the given position
-					for (AnimationTrack::KeyframeMap::const_iterator it = keyframes.constEnd(); it != keyframes.constBegin();)
+					for (int i = keyframes.size() - 1; i >= 0; --i)
 					{
-						--it;
-						QPoint keyframePos = keyframePoint(it.key(), it.value().Value);
+						QPoint keyframePos = keyframePoint(keyframes.time(i), keyframes.value(i));
 						const double scale = 1.0;
 						QPoint handleOffset = keyframePointOffset(
-						    it.value().Interpolation.Bezier.OutTangentX * scale,
-						    -it.value().Interpolation.Bezier.OutTangentY * scale);
+						    keyframes.parameter(AnimationKeyframeArray::OutTangentX, i) * scale,
+						    -keyframes.parameter(AnimationKeyframeArray::OutTangentY, i) * scale);
 						QPoint handlePoint = keyframePos + handleOffset;
 						if (abs(handlePoint.x() - pos.x()) <= handleHalfSize && abs(handlePoint.y() - pos.y()) <= handleHalfSize)
 						{
 							if (trackRes)
 								*trackRes = track;
-							return it.value().Id;
+							return keyframes.id(i);
 						}
 					}
 				}
@@ -851,21 +849,22 @@ QSet<ptrdiff_t> AnimationCurveEditor::keyframesAtPosition(const QPoint &pos) con
 	QSet<ptrdiff_t> res;
 	for (AnimationTrack *track : m_AnimationTracks)
 	{
-		const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
-		if (keyframes.begin() != keyframes.end())
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
+		if (!keyframes.isEmpty())
 		{
 			// Check if the pos time is between the first and last keyframe
-			double firstTime = keyframes.begin().key();
-			double lastTime = std::prev(keyframes.end()).key();
+			double firstTime = keyframes.time(0);
+			double lastTime = keyframes.time(keyframes.size() - 1);
 			if (timeAtX(pos.x() + keyframeHalfSize) >= firstTime && timeAtX(pos.x() - keyframeHalfSize) <= lastTime)
 			{
-				// Find the keyframe at the given position
-				for (auto it = keyframes.begin(); it != keyframes.end(); ++it)
+				// Find the keyframes at the given position, among the keyframes within the marker size horizontally
+				int to = keyframes.upperBound(timeAtX(pos.x() + keyframeHalfSize + 1));
+				for (int i = keyframes.lowerBound(timeAtX(pos.x() - keyframeHalfSize - 1)); i < to; ++i)
 				{
-					QPoint keyframePos = keyframePoint(it.key(), it.value().Value);
+					QPoint keyframePos = keyframePoint(keyframes.time(i), keyframes.value(i));
 					if (abs(keyframePos.x() - pos.x()) <= keyframeHalfSize && abs(keyframePos.y() - pos.y()) <= keyframeHalfSize)
 					{
-						res.insert(it.value().Id);
+						res.insert(keyframes.id(i));
 					}
 				}
 			}
@@ -882,11 +881,11 @@ QSet<ptrdiff_t> AnimationCurveEditor::keyframesInRect(const QRect &rect) const
 
 	for (AnimationTrack *track : m_AnimationTracks)
 	{
-		const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
 		if (!keyframes.isEmpty())
 		{
-			double firstTime = keyframes.begin().key();
-			double lastTime = std::prev(keyframes.end()).key();
+			double firstTime = keyframes.time(0);
+			double lastTime = keyframes.time(keyframes.size() - 1);
 			int firstTimeX = keyframePoint(firstTime, 0).x();
 			int lastTimeX = keyframePoint(lastTime, 0).x();
 
@@ -894,12 +893,15 @@ QSet<ptrdiff_t> AnimationCurveEditor::keyframesInRect(const QRect &rect) const
 
 			if (expandedRect.intersects(trackTimeRect))
 			{
-				for (auto it = keyframes.begin(); it != keyframes.end(); ++it)
+				// Only visit the keyframes within the time range of the rectangle
+				int from = keyframes.lowerBound(timeAtX(expandedRect.left() - 1));
+				int to = keyframes.upperBound(timeAtX(expandedRect.right() + 1));
+				for (int i = from; i < to; ++i)
 				{
-					QPoint keyframePos = keyframePoint(it.key(), it.value().Value);
+					QPoint keyframePos = keyframePoint(keyframes.time(i), keyframes.value(i));
 					if (expandedRect.contains(keyframePos))
 					{
-						res.insert(it.value().Id);
+						res.insert(keyframes.id(i));
 					}
 				}
 			}
@@ -995,7 +997,7 @@ static QColor lerp(const QColor &color1, const QColor &color2, qreal t)
 	return QColor::fromRgbF(r, g, b, a);
 }
 
-void AnimationCurveEditor::paintKeyframe(QPainter &painter, const QRect &rect, bool selected, bool hover, bool active)
+void AnimationCurveEditor::paintKeyframe(QPainter &painter, const QRect &rect, bool selected, bool hover, bool active, bool dropShadow)
 {
 	// Adjust the keyframe size
 	QRect adjustedRect = rect.adjusted(2, 2, -1, -1);
@@ -1071,7 +1073,8 @@ void AnimationCurveEditor::paintKeyframe(QPainter &painter, const QRect &rect, b
 
 	painter.save();
 	painter.setRenderHint(QPainter::Antialiasing, true);
-	painter.fillPath(shadowPath, shadowBrush);
+	if (dropShadow)
+		painter.fillPath(shadowPath, shadowBrush);
 	painter.fillPath(path, brush);
 
 	// Draw the border
@@ -1268,125 +1271,447 @@ void AnimationCurveEditor::paintValueRuler(QPainter &painter)
 	}
 }
 
-void AnimationCurveEditor::paintCurve(QPainter &painter, AnimationTrack *track, const QColor &curveColor)
+// Append a cubic Bezier curve to the path, pieces that are flat within a fraction of a pixel or outside of the
+// area become lines, and pieces within it are split until they fit within maxSize, so that a far zoom
+// does not make the painter flatten a curve that is mostly outside of the view
+static void appendCubic(QPainterPath &path, const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3, const QRectF &area, const QSizeF &maxSize, int depth = 0)
+{
+	const double flatness = 0.25;
+	const int maxDepth = 16;
+
+	// The curve stays within 3/4 of the distance of the inner control points from the chord
+	QPointF chord = p3 - p0;
+	double length = std::hypot(chord.x(), chord.y());
+	double distance;
+	if (length > 1e-6)
+	{
+		QPointF d1 = p1 - p0;
+		QPointF d2 = p2 - p0;
+		distance = std::max(std::abs(d1.x() * chord.y() - d1.y() * chord.x()), std::abs(d2.x() * chord.y() - d2.y() * chord.x())) / length;
+	}
+	else
+	{
+		distance = std::max(std::hypot(p1.x() - p0.x(), p1.y() - p0.y()), std::hypot(p2.x() - p0.x(), p2.y() - p0.y()));
+	}
+	if (distance <= flatness || depth >= maxDepth)
+	{
+		path.lineTo(p3);
+		return;
+	}
+
+	// The chord stays within the control polygon, so it is outside of the area as well when the polygon is
+	double minX = std::min(std::min(p0.x(), p1.x()), std::min(p2.x(), p3.x()));
+	double maxX = std::max(std::max(p0.x(), p1.x()), std::max(p2.x(), p3.x()));
+	double minY = std::min(std::min(p0.y(), p1.y()), std::min(p2.y(), p3.y()));
+	double maxY = std::max(std::max(p0.y(), p1.y()), std::max(p2.y(), p3.y()));
+	if (maxX < area.left() || minX > area.right() || maxY < area.top() || minY > area.bottom())
+	{
+		path.lineTo(p3);
+		return;
+	}
+	if (maxX - minX <= maxSize.width() && maxY - minY <= maxSize.height())
+	{
+		path.cubicTo(p1, p2, p3);
+		return;
+	}
+
+	// Split in half
+	QPointF p01 = (p0 + p1) * 0.5;
+	QPointF p12 = (p1 + p2) * 0.5;
+	QPointF p23 = (p2 + p3) * 0.5;
+	QPointF p012 = (p01 + p12) * 0.5;
+	QPointF p123 = (p12 + p23) * 0.5;
+	QPointF mid = (p012 + p123) * 0.5;
+	appendCubic(path, p0, p01, p012, mid, area, maxSize, depth + 1);
+	appendCubic(path, mid, p123, p23, p3, area, maxSize, depth + 1);
+}
+
+void AnimationCurveEditor::paintCurve(QPainter &painter, AnimationTrack *track, const QColor &curveColor, const QRect &rect)
 {
 	QPen curvePen = QPen(curveColor);
 	curvePen.setWidthF(1.5);
 	painter.setPen(curvePen);
 
-	const double pxStep = 2;
-	const double fromX = keyframePointF(m_FromTime, 0).x(); // TODO: Adjust to 0 time aligned with framerate or pxStep
-	const double toX = keyframePointF(m_ToTime, 0).x(); // TODO: Adjust to 0 time aligned with framerate or pxStep
+	// The cached path is in pixels from time and value zero, the view offset translates it into the grid
+	const QRect grid = gridRect();
+	const double pixelPerTime = grid.width() / (m_ToTime - m_FromTime);
+	const double pixelPerValue = m_VerticalPixelPerValue;
+	const QPointF offset(grid.left() - m_FromTime * pixelPerTime, grid.center().y() + m_VerticalCenterValue * pixelPerValue);
+
+	// Only the part of the curve that crosses the painted rectangle, with a margin for the pen
+	const QRectF visible = QRectF(rect).adjusted(-2.0, -2.0, 2.0, 2.0).translated(-offset);
+
+	// A pan changes both ends of the time range, which may round the scale differently
+	auto sameScale = [](double a, double b) { return std::abs(a - b) <= std::abs(a) * 1e-9; };
+
+	QHash<const AnimationTrack *, CurveCache>::iterator it = m_CurveCache.find(track);
+	bool upToDate = it != m_CurveCache.end() && it->CurveVersion == track->curveVersion();
+	upToDate = upToDate && sameScale(it->PixelPerTime, pixelPerTime) && sameScale(it->PixelPerValue, pixelPerValue);
+	if (!upToDate || !it->Area.contains(visible))
+	{
+		// Build for the view and one view size around it in every direction, panning within that reuses the path
+		QRectF view = QRectF(grid).translated(-offset);
+		CurveCache cache;
+		cache.CurveVersion = track->curveVersion();
+		cache.PixelPerTime = pixelPerTime;
+		cache.PixelPerValue = pixelPerValue;
+		cache.Area = view.adjusted(-view.width(), -view.height(), view.width(), view.height());
+		cache.Path = curvePath(track, pixelPerTime, pixelPerValue, cache.Area, grid.size());
+		it = m_CurveCache.insert(track, cache);
+	}
 
-	const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
-	AnimationTrack::KeyframeMap::const_iterator it = keyframes.begin();
+	painter.save();
+	painter.translate(offset);
+	painter.drawPath(it->Path);
+	painter.restore();
+}
+
+QPainterPath AnimationCurveEditor::curvePath(AnimationTrack *track, double pixelPerTime, double pixelPerValue, const QRectF &area, const QSizeF &maxSize) const
+{
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	const AnimationInterpolation method = track->interpolationMethod();
+	const double toTime = area.right() / pixelPerTime;
+	auto point = [pixelPerTime, pixelPerValue](double time, double value) { return QPointF(time * pixelPerTime, -value * pixelPerValue); };
 
 	// Check if the track has at least two keyframes
 	QPainterPath path;
-	if (it != keyframes.end() && std::next(it) != keyframes.end())
+	if (keyframes.size() >= 2)
 	{
-		QPointF lastPoint;
+		AnimationTrack::SegmentView view = track->segmentView();
 
-		bool withinTimeRange = false;
+		// Start at the segment under the left edge
+		int first = std::max(keyframes.upperBound(area.left() / pixelPerTime) - 1, 0);
+		QPointF p0 = point(keyframes.time(first), keyframes.value(first));
+		path.moveTo(p0);
 
-		for (; std::next(it) != keyframes.end(); ++it)
+		for (int i = first; i + 1 < keyframes.size(); ++i)
 		{
-			double time1 = it.key();
-			double time2 = std::next(it).key();
+			double time1 = keyframes.time(i);
+			double time2 = keyframes.time(i + 1);
 
-			if (!withinTimeRange && keyframePointF(time2, 0).x() >= fromX)
-			{
-				// We are now within the time range
-				lastPoint = keyframePointF(it.key(), it.value().Value);
-				path.moveTo(lastPoint);
-				withinTimeRange = true;
-			}
+			// If time1 is beyond the area, we can exit the loop early
+			if (time1 > toTime)
+				break;
 
-			if (withinTimeRange)
+			QPointF p3 = point(time2, keyframes.value(i + 1));
+
+			// Where the segments are narrower than a pixel, the keyframes up to the end of the pixel column are drawn
+			// as one vertical span over the range of the curve, which costs the same however many keyframes there are
+			if (p3.x() - p0.x() < 1.0)
 			{
-				if (track->interpolationMethod() == AnimationInterpolation::Linear)
+				double columnEnd = std::floor(p0.x()) + 1.0;
+				int last = std::max(keyframes.upperBound(columnEnd / pixelPerTime) - 1, i + 1);
+				double minValue, maxValue;
+				if (last > i + 1 && track->valueRange(i, last, minValue, maxValue))
 				{
-					// If time1 is beyond the m_ToTime, we can exit the loop early
-					if (time1 > m_ToTime)
-						break;
-
-					QPointF nextPoint = keyframePointF(time2, std::next(it).value().Value);
-					path.lineTo(nextPoint);
-					lastPoint = nextPoint;
+					path.lineTo(p0.x(), -maxValue * pixelPerValue);
+					path.lineTo(p0.x(), -minValue * pixelPerValue);
+					p0 = point(keyframes.time(last), keyframes.value(last));
+					path.lineTo(p0);
+					i = last - 1;
+					continue;
 				}
-				else
+			}
+
+			switch (method)
+			{
+			case AnimationInterpolation::Step:
+				path.lineTo(p3.x(), p0.y());
+				path.lineTo(p3);
+				break;
+			case AnimationInterpolation::Linear:
+				path.lineTo(p3);
+				break;
+			default:
+			{
+				// Time and value are both cubic in the segment parameter, and the view maps them linearly, so the
+				// segment is a cubic Bezier curve on screen, with the inner control points taken from the power basis
+				const AnimationCurveSegment<double> &segment = view.Segments[i];
+				double u1 = 1.0 / 3.0;
+				double u2 = 2.0 / 3.0;
+				if (method == AnimationInterpolation::Bezier)
 				{
-					double x = lastPoint.x();
-					x += pxStep;
-					double timeX = timeAtX(x);
-					while (timeX <= time2)
-					{
-						// If lastPoint is beyond the toX, we can exit the loop early
-						if (lastPoint.x() > toX)
-							break;
-
-						QPointF nextPoint = keyframePointF(timeX, track->valueAtTime(it, std::next(it), timeX));
-						path.lineTo(nextPoint);
-						lastPoint = nextPoint;
-						x += pxStep;
-						timeX = timeAtX(x);
-					}
-					if (lastPoint.x() > toX)
-						break;
+					const AnimationBezierTiming<double> &timing = view.Timings[i];
+					u1 = timing.X1 / 3.0;
+					u2 = (2.0 * timing.X1 + timing.X2) / 3.0;
 				}
+				double duration = time2 - time1;
+				QPointF p1 = point(time1 + u1 * duration, segment.C0 + segment.C1 / 3.0);
+				QPointF p2 = point(time1 + u2 * duration, segment.C0 + (2.0 * segment.C1 + segment.C2) / 3.0);
+				appendCubic(path, p0, p1, p2, p3, area, maxSize);
+				break;
+			}
 			}
+			p0 = p3;
 		}
 	}
-	painter.drawPath(path);
+	return path;
 }
 
-void AnimationCurveEditor::paintEvent(QPaintEvent *event)
+AnimationCurveEditor::LayerView AnimationCurveEditor::layerView() const
 {
-	Q_UNUSED(event);
+	LayerView view;
+	view.Size = size();
+	view.DevicePixelRatio = devicePixelRatioF();
+	view.FromTime = m_FromTime;
+	view.ToTime = m_ToTime;
+	view.VerticalCenterValue = m_VerticalCenterValue;
+	view.VerticalPixelPerValue = m_VerticalPixelPerValue;
+	return view;
+}
 
-	QPainter painter(this);
+bool AnimationCurveEditor::LayerView::operator==(const LayerView &other) const
+{
+	return Size == other.Size && DevicePixelRatio == other.DevicePixelRatio
+	    && FromTime == other.FromTime && ToTime == other.ToTime
+	    && VerticalCenterValue == other.VerticalCenterValue && VerticalPixelPerValue == other.VerticalPixelPerValue;
+}
 
-	// Paint the background with frame
-	paintEditorBackground(painter);
+// Rectangle of the layer pixels behind a rectangle of the widget
+static QRectF layerRect(const QRect &rect, qreal devicePixelRatio)
+{
+	return QRectF(rect.x() * devicePixelRatio, rect.y() * devicePixelRatio, rect.width() * devicePixelRatio, rect.height() * devicePixelRatio);
+}
 
-	// Paint the grid
-	QRect grid = gridRect();
-	painter.setClipRect(grid);
-	paintGrid(painter);
-	paintValueRuler(painter);
+bool AnimationCurveEditor::scrollLayer(QPixmap &layer, LayerView &layerView, const LayerView &view, QPoint &delta) const
+{
+	delta = QPoint();
+	if (layer.isNull())
+		return false;
+	if (layerView == view)
+		return true;
+
+	// Only a pan keeps the scale, it moves both ends of the time range, which may round the duration differently
+	const double duration = view.ToTime - view.FromTime;
+	if (layerView.Size != view.Size || layerView.DevicePixelRatio != view.DevicePixelRatio || layerView.VerticalPixelPerValue != view.VerticalPixelPerValue
+	    || std::abs((layerView.ToTime - layerView.FromTime) - duration) > std::abs(duration) * 1e-9)
+		return false;
+
+	// A pan that follows the mouse moves by whole pixels, for which the keyframes round to the same pixels as before
+	const QRect grid = gridRect();
+	const double dx = (layerView.FromTime - view.FromTime) / duration * grid.width();
+	const double dy = (view.VerticalCenterValue - layerView.VerticalCenterValue) * view.VerticalPixelPerValue;
+	const double deviceDx = dx * view.DevicePixelRatio;
+	const double deviceDy = dy * view.DevicePixelRatio;
+	auto whole = [](double pixels) { return std::abs(pixels - std::round(pixels)) < 1e-3; };
+	if (!whole(dx) || !whole(dy) || !whole(deviceDx) || !whole(deviceDy))
+		return false;
+	delta = QPoint(std::lround(dx), std::lround(dy));
+	if (std::abs(delta.x()) >= grid.width() || std::abs(delta.y()) >= grid.height())
+		return false;
+
+	layer.scroll(std::lround(deviceDx), std::lround(deviceDy), layerRect(grid, view.DevicePixelRatio).toRect());
+	layerView = view;
+	return true;
+}
+
+void AnimationCurveEditor::updateLayers()
+{
+	const LayerView view = layerView();
+	const QRect grid = gridRect();
+
+	// Paint the background with frame, the grid and the value ruler, where they came into view when panning
+	QPoint delta;
+	QRegion dirty;
+	if (scrollLayer(m_GridLayer, m_GridLayerView, view, delta))
+	{
+		if (!delta.isNull())
+		{
+			// The value ruler stays at the left edge of the grid, and its labels may reach left of the ticks
+			const int rulerWidth = 48;
+			QRect ruler(grid.left() - rulerWidth, grid.top(), rulerWidth * 3, grid.height());
+			dirty = QRegion(grid) - QRegion(grid.translated(delta));
+			dirty += ruler;
+			dirty += ruler.translated(delta.x(), 0);
+			dirty &= grid;
+		}
+	}
+	else
+	{
+		m_GridLayer = QPixmap(view.Size * view.DevicePixelRatio);
+		m_GridLayer.setDevicePixelRatio(view.DevicePixelRatio);
+		m_GridLayer.fill(Qt::transparent);
+		m_GridLayerView = view;
+		dirty = QRegion(0, 0, view.Size.width(), view.Size.height());
+	}
+	if (!dirty.isEmpty())
+	{
+		QPainter painter(&m_GridLayer);
+		painter.setClipRegion(dirty);
+		paintEditorBackground(painter);
+		painter.setClipRegion(dirty & grid);
+		paintGrid(painter);
+		paintValueRuler(painter);
+	}
+
+	// Move the curves with the grid when panning, anything else moves every curve
+	if (scrollLayer(m_CurveLayer, m_CurveLayerView, view, delta))
+	{
+		// The changed tracks were reported where they were painted
+		m_CurveLayerDirty.translate(delta);
+		if (!delta.isNull())
+			m_CurveLayerDirty += QRegion(grid) - QRegion(grid.translated(delta));
+	}
+	else
+	{
+		m_CurveLayer = QPixmap(view.Size * view.DevicePixelRatio);
+		m_CurveLayer.setDevicePixelRatio(view.DevicePixelRatio);
+		m_CurveLayer.fill(Qt::transparent);
+		m_CurveLayerView = view;
+		m_CurveLayerDirty = QRegion(grid);
+	}
+
+	// Repaint the curves where they changed, rectangle by rectangle unless the tracks changed in many places
+	dirty = m_CurveLayerDirty & grid;
+	m_CurveLayerDirty = QRegion();
+	if (!dirty.isEmpty())
+	{
+		QList<QRect> rects;
+		if (dirty.rectCount() <= 4)
+			rects = QList<QRect>(dirty.begin(), dirty.end());
+		else
+			rects.append(dirty.boundingRect());
+
+		QPainter painter(&m_CurveLayer);
+		for (const QRect &rect : rects)
+		{
+			painter.setClipRect(rect);
+			painter.setCompositionMode(QPainter::CompositionMode_Source);
+			painter.fillRect(rect, Qt::transparent);
+			painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+			paintCurveLayer(painter, rect);
+		}
+	}
+}
+
+void AnimationCurveEditor::paintCurveLayer(QPainter &painter, const QRect &rect)
+{
+	// Dense keyframes are grouped by buckets one marker wide, counted in pixels from time zero,
+	// so the groups do not depend on the painted rectangle or on panning
+	const int keyframeHalfSize = 6;
+	const QRect grid = gridRect();
+	const double pixelPerTime = grid.width() / (m_ToTime - m_FromTime);
+	const double originX = grid.left() - m_FromTime * pixelPerTime;
+	const double bucketWidth = keyframeHalfSize * 2;
+	auto bucketTime = [pixelPerTime, bucketWidth](double bucket) { return bucket * bucketWidth / pixelPerTime; };
+
+	// Buckets with markers that reach into the rectangle
+	const double firstBucket = std::floor((rect.left() - keyframeHalfSize - 1 - originX) / bucketWidth);
+	const double lastBucket = std::floor((rect.right() + keyframeHalfSize + 1 - originX) / bucketWidth);
+	for (AnimationTrack *track : m_AnimationTracks)
+	{
+		QColor curveColor = track->color();
+		painter.setRenderHint(QPainter::Antialiasing, true);
+		paintCurve(painter, track, curveColor, rect);
+
+		// Keyframes as they look when not selected, hovered or active, the overlay paints those over them
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
+		painter.setRenderHint(QPainter::Antialiasing, false);
+		int from = keyframes.lowerBound(bucketTime(firstBucket));
+		int to = keyframes.lowerBound(bucketTime(lastBucket + 1.0));
+		for (int i = from; i < to;)
+		{
+			QPoint point = keyframePoint(keyframes.time(i), keyframes.value(i));
+
+			// The keyframes within the bucket are drawn as one marker at their lowest and highest value,
+			// the bucket is taken from the same boundaries as the search so rounding cannot split it
+			double bucket = std::floor(keyframes.time(i) * pixelPerTime / bucketWidth);
+			if (bucketTime(bucket + 1.0) <= keyframes.time(i))
+				bucket += 1.0;
+			else if (bucketTime(bucket) > keyframes.time(i))
+				bucket -= 1.0;
+			int next = std::max(keyframes.lowerBound(bucketTime(bucket + 1.0)), i + 1);
+			double minValue, maxValue;
+			if (next - i > 2 && track->keyframeValueRange(i, next - 1, minValue, maxValue))
+			{
+				QPoint top = keyframePoint(keyframes.time(i), maxValue);
+				QPoint bottom = keyframePoint(keyframes.time(i), minValue);
+				QRect topRect = QRect(top.x() - keyframeHalfSize, top.y() - keyframeHalfSize, keyframeHalfSize * 2, keyframeHalfSize * 2);
+				QRect bottomRect = QRect(bottom.x() - keyframeHalfSize, bottom.y() - keyframeHalfSize, keyframeHalfSize * 2, keyframeHalfSize * 2);
+				if (bottomRect.intersects(rect))
+					paintKeyframe(painter, bottomRect, false, false, false);
+				if (bottom.y() - top.y() > keyframeHalfSize && topRect.intersects(rect))
+					paintKeyframe(painter, topRect, false, false, false);
+				i = next;
+				continue;
+			}
+
+			QRect keyframeRect = QRect(point.x() - keyframeHalfSize, point.y() - keyframeHalfSize, keyframeHalfSize * 2, keyframeHalfSize * 2);
+			if (keyframeRect.intersects(rect))
+				paintKeyframe(painter, keyframeRect, false, false, false);
+			++i;
+		}
+	}
+}
+
+QRect AnimationCurveEditor::keyframeBucketsRect(const QRect &rect) const
+{
+	// Full height columns of the keyframe buckets of paintCurveLayer within the rectangle, with room for their markers
+	if (rect.isEmpty())
+		return rect;
+	const int keyframeHalfSize = 6;
+	const QRect grid = gridRect();
+	const double pixelPerTime = grid.width() / (m_ToTime - m_FromTime);
+	const double originX = grid.left() - m_FromTime * pixelPerTime;
+	const double bucketWidth = keyframeHalfSize * 2;
+	double left = std::floor((rect.left() - originX) / bucketWidth) * bucketWidth + originX;
+	double right = (std::floor((rect.right() - originX) / bucketWidth) + 1.0) * bucketWidth + originX;
+	QPoint topLeft(static_cast<int>(std::floor(left)) - keyframeHalfSize - 1, grid.top());
+	QPoint bottomRight(static_cast<int>(std::ceil(right)) + keyframeHalfSize + 1, grid.bottom());
+	return QRect(topLeft, bottomRight) & grid;
+}
+
+void AnimationCurveEditor::paintOverlay(QPainter &painter, const QRect &rect)
+{
+	const int keyframeHalfSize = 6;
 
 	// Handle pen
 	QPen handlePen = QPen(palette().color(QPalette::ButtonText));
 	handlePen.setWidthF(0.75);
 
-	// Paint the curves
+	// Paint the keyframes that are selected, hovered or active, and the handles of the selection
+	const bool anySelected = !m_SelectedKeyframes.isEmpty() || !m_SelectedLeftInterpolationHandles.isEmpty() || !m_SelectedRightInterpolationHandles.isEmpty();
 	for (AnimationTrack *track : m_AnimationTracks)
 	{
-		QColor curveColor = track->color();
-		painter.setRenderHint(QPainter::Antialiasing, true);
-		paintCurve(painter, track, curveColor);
+		// Without a selection, only the hovered track has anything to draw
+		if (!anySelected && track != m_HoverTrack)
+			continue;
 
-		const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
+		const bool bezier = track->interpolationMethod() == AnimationInterpolation::Bezier;
 		painter.setRenderHint(QPainter::Antialiasing, false);
-		for (AnimationTrack::KeyframeMap::const_iterator it = keyframes.begin(); it != keyframes.end(); ++it)
+
+		// Handles reach outside of the time range of their keyframes
+		int from = 0;
+		int to = keyframes.size();
+		if (!bezier || !anySelected)
+		{
+			from = keyframes.lowerBound(timeAtX(rect.left() - keyframeHalfSize));
+			to = keyframes.upperBound(timeAtX(rect.right() + keyframeHalfSize));
+		}
+		for (int i = from; i < to; ++i)
 		{
-			QPoint point = keyframePoint(it.key(), it.value().Value);
-			bool selected = m_SelectedKeyframes.contains(it.value().Id);
-			if (track->interpolationMethod() == AnimationInterpolation::Bezier)
+			ptrdiff_t id = keyframes.id(i);
+			bool selected = m_SelectedKeyframes.contains(id);
+			bool hover = m_HoverKeyframe == id;
+			bool active = (m_ActiveKeyframe == id) && hover;
+			bool handles = false;
+			QPoint point = keyframePoint(keyframes.time(i), keyframes.value(i));
+			if (bezier)
 			{
-				bool leftSelected = m_SelectedLeftInterpolationHandles.contains(it.value().Id);
-				bool rightSelected = m_SelectedRightInterpolationHandles.contains(it.value().Id);
+				bool leftSelected = m_SelectedLeftInterpolationHandles.contains(id);
+				bool rightSelected = m_SelectedRightInterpolationHandles.contains(id);
 				if (selected || leftSelected || rightSelected)
 				{
 					const double scale = 1.0;
 					const int handleHalfSize = 3;
 					QPoint leftOffset = keyframePointOffset(
-					    it.value().Interpolation.Bezier.InTangentX * scale,
-					    -it.value().Interpolation.Bezier.InTangentY * scale);
+					    keyframes.parameter(AnimationKeyframeArray::InTangentX, i) * scale,
+					    -keyframes.parameter(AnimationKeyframeArray::InTangentY, i) * scale);
 					QPoint leftPoint = point + leftOffset;
 					QPoint rightOffset = keyframePointOffset(
-					    it.value().Interpolation.Bezier.OutTangentX * scale,
-					    -it.value().Interpolation.Bezier.OutTangentY * scale);
+					    keyframes.parameter(AnimationKeyframeArray::OutTangentX, i) * scale,
+					    -keyframes.parameter(AnimationKeyframeArray::OutTangentY, i) * scale);
 					QPoint rightPoint = point + rightOffset;
 					QRect leftHandleRect = QRect(leftPoint.x() - handleHalfSize, leftPoint.y() - handleHalfSize, handleHalfSize * 2, handleHalfSize * 2);
 					QRect rightHandleRect = QRect(rightPoint.x() - handleHalfSize, rightPoint.y() - handleHalfSize, handleHalfSize * 2, handleHalfSize * 2);
@@ -1395,18 +1720,22 @@ void AnimationCurveEditor::paintEvent(QPaintEvent *event)
 					painter.drawLine(point, leftPoint);
 					painter.drawLine(point, rightPoint);
 					painter.setRenderHint(QPainter::Antialiasing, false);
-					bool leftHover = m_HoverLeftInterpolationHandle == it.value().Id;
-					bool leftActive = (m_ActiveLeftInterpolationHandle == it.value().Id) && leftHover;
+					bool leftHover = m_HoverLeftInterpolationHandle == id;
+					bool leftActive = (m_ActiveLeftInterpolationHandle == id) && leftHover;
 					paintInterpolationHandle(painter, leftHandleRect, leftSelected, leftHover, leftActive);
-					bool rightHover = m_HoverRightInterpolationHandle == it.value().Id;
-					bool rightActive = (m_ActiveRightInterpolationHandle == it.value().Id) && rightHover;
+					bool rightHover = m_HoverRightInterpolationHandle == id;
+					bool rightActive = (m_ActiveRightInterpolationHandle == id) && rightHover;
 					paintInterpolationHandle(painter, rightHandleRect, rightSelected, rightHover, rightActive);
+					handles = true;
 				}
 			}
-			bool hover = m_HoverKeyframe == it.value().Id;
-			bool active = (m_ActiveKeyframe == it.value().Id) && hover;
-			QRect keyframeRect = QRect(point.x() - 6, point.y() - 6, 12, 12);
-			paintKeyframe(painter, keyframeRect, selected, hover, active);
+
+			// Covers the keyframe of the curve layer, which already has the shadow, and the handle lines
+			if (selected || hover || handles)
+			{
+				QRect keyframeRect = QRect(point.x() - keyframeHalfSize, point.y() - keyframeHalfSize, keyframeHalfSize * 2, keyframeHalfSize * 2);
+				paintKeyframe(painter, keyframeRect, selected, hover, active, false);
+			}
 		}
 	}
 
@@ -1421,6 +1750,33 @@ void AnimationCurveEditor::paintEvent(QPaintEvent *event)
 	}
 }
 
+void AnimationCurveEditor::paintEvent(QPaintEvent *event)
+{
+	updateLayers();
+
+	// Compose the layers within the painted rectangle
+	QPainter painter(this);
+	const QRect rect = event->rect();
+	const qreal devicePixelRatio = m_CurveLayerView.DevicePixelRatio;
+	painter.drawPixmap(QRectF(rect), m_GridLayer, layerRect(rect, devicePixelRatio));
+	painter.drawPixmap(QRectF(rect), m_CurveLayer, layerRect(rect, devicePixelRatio));
+
+	// Paint the overlay
+	painter.setClipRect(gridRect());
+	paintOverlay(painter, rect);
+}
+
+void AnimationCurveEditor::changeEvent(QEvent *event)
+{
+	// The palette and the style change the look of every layer
+	if (event->type() == QEvent::PaletteChange || event->type() == QEvent::StyleChange)
+	{
+		m_GridLayer = QPixmap();
+		m_CurveLayer = QPixmap();
+	}
+	QWidget::changeEvent(event);
+}
+
 void AnimationCurveEditor::removeTrack()
 {
 	// Implement removing the track
@@ -1441,6 +1797,39 @@ void AnimationCurveEditor::onContextMenuClosed()
 	// ...
 }
 
+void AnimationCurveEditor::onKeyframesRangeChanged(double fromTime, double toTime, double minValue, double maxValue)
+{
+	// Nothing was drawn before or after the change
+	if (minValue > maxValue)
+		return;
+
+	// Repaint the area that the curve covered before and after the change, with room for the keyframes
+	const int margin = 8;
+	QRect grid = gridRect();
+	QPointF topLeft = keyframePointF(std::clamp(fromTime, m_FromTime, m_ToTime), maxValue);
+	QPointF bottomRight = keyframePointF(std::clamp(toTime, m_FromTime, m_ToTime), minValue);
+	double top = std::clamp(topLeft.y(), static_cast<double>(grid.top() - margin), static_cast<double>(grid.bottom() + margin));
+	double bottom = std::clamp(bottomRight.y(), static_cast<double>(grid.top() - margin), static_cast<double>(grid.bottom() + margin));
+	QRect rect = QRectF(QPointF(topLeft.x(), top), QPointF(bottomRight.x(), bottom)).toAlignedRect();
+	rect = rect.adjusted(-margin, -margin, margin, margin) & grid;
+
+	// The markers of a group of keyframes may move anywhere up or down its bucket
+	rect = keyframeBucketsRect(rect);
+	update(rect);
+
+	// The curve layer is in the view it was last painted in, which is only known to match the current one when it is the same
+	if (m_CurveLayerView == layerView())
+		m_CurveLayerDirty += rect;
+	else
+		m_CurveLayerDirty = QRegion(grid);
+}
+
+void AnimationCurveEditor::invalidateCurveLayer()
+{
+	m_CurveLayerDirty = QRegion(gridRect());
+	update();
+}
+
 void AnimationCurveEditor::enterEvent(QEnterEvent *event)
 {
 	// ...
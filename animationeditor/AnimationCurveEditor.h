@@ -37,9 +37,16 @@ This library contains code that was generated using ChatGPT and Copilot.
 
 #include <QWidget>
 #include <QSet>
+#include <QHash>
 #include <QRect>
+#include <QRegion>
+#include <QPixmap>
+#include <QPainterPath>
 
 #include "AnimationTrack.h"
+#include "AnimationDragSession.h"
+#include "AnimationUndoJournal.h"
+#include "AnimationKeyframeIndex.h"
 
 class QTreeWidget;
 class QMenu;
@@ -61,6 +68,12 @@ public:
 	void setKeyframeSelection(const QSet<ptrdiff_t> &selection);
 	QSet<ptrdiff_t> keyframeSelection() const;
 
+	// Set the journal that records the edits made in the editor, may be null
+	void setUndoJournal(AnimationUndoJournal *journal);
+
+	// Set the index used to find the selected keyframes, may be null
+	void setKeyframeIndex(AnimationKeyframeIndex *index);
+
 signals:
 	void rangeChanged(double fromTime, double toTime);
 	void trackRemoved(AnimationTrack *track);
@@ -71,6 +84,7 @@ protected:
 	// Override paintEvent to customize drawing
 	void resizeEvent(QResizeEvent *event) override;
 	void paintEvent(QPaintEvent *event) override;
+	void changeEvent(QEvent *event) override;
 
 	// Additional event handlers for mouse interactions
 	void mousePressEvent(QMouseEvent *event) override;
@@ -89,6 +103,10 @@ private slots:
 	void removeKeyframe();
 	void onContextMenuClosed();
 
+	// Track changes
+	void onKeyframesRangeChanged(double fromTime, double toTime, double minValue, double maxValue);
+	void invalidateCurveLayer();
+
 private:
 	// Context menu management
 	void createContextMenu();
@@ -126,10 +144,29 @@ private:
 	void paintEditorBackground(QPainter &painter);
 	void paintGrid(QPainter &painter);
 	void paintValueRuler(QPainter &painter);
-	void paintCurve(QPainter &painter, AnimationTrack *track, const QColor &curveColor);
-	void paintKeyframe(QPainter &painter, const QRect &rect, bool selected, bool hover, bool active);
+	void paintCurve(QPainter &painter, AnimationTrack *track, const QColor &curveColor, const QRect &rect);
+	QPainterPath curvePath(AnimationTrack *track, double pixelPerTime, double pixelPerValue, const QRectF &area, const QSizeF &maxSize) const;
+	void paintKeyframe(QPainter &painter, const QRect &rect, bool selected, bool hover, bool active, bool dropShadow = true);
 	void paintInterpolationHandle(QPainter &painter, const QRect &rect, bool selected, bool hover, bool active);
 
+	// Layer management, paintEvent composes the grid and curve layers and paints the overlay over them
+	struct LayerView
+	{
+		QSize Size;
+		qreal DevicePixelRatio = 0.0;
+		double FromTime = 0.0;
+		double ToTime = 0.0;
+		double VerticalCenterValue = 0.0;
+		double VerticalPixelPerValue = 0.0;
+		bool operator==(const LayerView &other) const;
+	};
+	LayerView layerView() const;
+	bool scrollLayer(QPixmap &layer, LayerView &layerView, const LayerView &view, QPoint &delta) const;
+	void updateLayers();
+	void paintCurveLayer(QPainter &painter, const QRect &rect);
+	QRect keyframeBucketsRect(const QRect &rect) const;
+	void paintOverlay(QPainter &painter, const QRect &rect);
+
 	// Mouse interaction helper functions
 	void updateMousePosition(const QPoint &pos, bool ctrlHeld);
 	void updateMouseSelection(bool ctrlHeld);
@@ -138,7 +175,9 @@ private:
 private:
 	QTreeWidget *m_DimensionalReference;
 	QList<AnimationTrack *> m_AnimationTracks;
-	QList<AnimationTrack::KeyframeMap> m_BackupAnimationTracks;
+	AnimationDragSession m_DragSession;
+	AnimationUndoJournal *m_UndoJournal = nullptr;
+	AnimationKeyframeIndex *m_KeyframeIndex = nullptr;
 	InteractionState m_InteractionState = InteractionState::None;
 	QSet<ptrdiff_t> m_SelectedKeyframes;
 	QSet<ptrdiff_t> m_SelectedLeftInterpolationHandles;
@@ -186,6 +225,28 @@ private:
 	double m_BackupVerticalCenterValue = 0;
 	double m_BackupFromTime = 0;
 	double m_BackupToTime = 0;
+
+	// Painted curve of every track, in pixels from time and value zero, so that panning only translates it
+	// Rebuilt when the curve or the scale changes, or when the view leaves the area it was built for
+	struct CurveCache
+	{
+		QPainterPath Path;
+		quint64 CurveVersion = 0;
+		double PixelPerTime = 0.0;
+		double PixelPerValue = 0.0;
+		QRectF Area; // Outside of this area, the path is reduced to lines
+	};
+	QHash<const AnimationTrack *, CurveCache> m_CurveCache;
+
+	// The grid layer holds the background, frame, grid and value ruler, and is repainted when the view changes
+	// The curve layer holds the curves and their keyframes as they look when idle, and is repainted where the tracks
+	// changed, so that hover, selection and the rubber band only repaint the overlay
+	// Panning scrolls both layers, and only paints the strips that come into view
+	QPixmap m_GridLayer;
+	LayerView m_GridLayerView;
+	QPixmap m_CurveLayer;
+	LayerView m_CurveLayerView;
+	QRegion m_CurveLayerDirty;
 };
 
 #endif /* ANIMATION_CURVE_EDITOR__H */
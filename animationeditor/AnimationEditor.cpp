@@ -36,11 +36,19 @@ This library contains code that was generated using ChatGPT and Copilot.
 #include <QSplitter>
 
 #include <QToolBar>
+#include <QToolButton>
+#include <QMenu>
 #include <QTreeWidget>
+#include <QAction>
+#include <QThreadPool>
+#include <QMutex>
+#include <QPointer>
 
 #include "AnimationTimelineEditor.h"
 #include "AnimationCurveEditor.h"
 #include "AnimationTimeScrubber.h"
+#include "AnimationUndoJournal.h"
+#include "AnimationKeyframeIndex.h"
 
 /*
 
@@ -64,6 +72,18 @@ The layout will automatically be set for the AnimationEditor widget.
 
 */
 
+// Keyframes of tracks converted on the thread pool, along with the state of the tracks they were taken from
+struct AnimationEditor::InterpolationConversion
+{
+	QMutex Mutex;
+	AnimationEditor *Editor; // Cleared when the editor is destroyed first
+	AnimationInterpolation InterpolationMethod;
+	QVector<QPointer<AnimationTrack>> Tracks;
+	QVector<std::shared_ptr<const AnimationTrackSnapshot>> Snapshots;
+	QVector<AnimationKeyframeArray> Keyframes;
+	QVector<AnimationInterpolation> From;
+};
+
 AnimationEditor::AnimationEditor(QWidget *parent)
     : QWidget(parent)
     , m_ToolBar(new QToolBar(this))
@@ -72,14 +92,64 @@ AnimationEditor::AnimationEditor(QWidget *parent)
     , m_TimelineEditor(new AnimationTimelineEditor(this))
     , m_CurveEditor(new AnimationCurveEditor(this, m_TrackTreeWidget))
     , m_TimeScrubber(new AnimationTimeScrubber(this, m_TrackTreeWidget))
+    , m_UndoJournal(new AnimationUndoJournal(this))
+    , m_KeyframeIndex(new AnimationKeyframeIndex(this))
 {
-	// Set up the toolbar
-	m_ToolBar->addAction("Action 1");
-	m_ToolBar->addAction("Action 2");
+	// Set up the toolbar, the undo and redo shortcuts apply anywhere in the editor
+	QAction *undoAction = new QAction(tr("Undo"), this);
+	undoAction->setShortcut(QKeySequence::Undo);
+	undoAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+	undoAction->setEnabled(false);
+	connect(undoAction, &QAction::triggered, m_UndoJournal, &AnimationUndoJournal::undo);
+	connect(m_UndoJournal, &AnimationUndoJournal::canUndoChanged, undoAction, &QAction::setEnabled);
+	connect(m_UndoJournal, &AnimationUndoJournal::undoTextChanged, undoAction, [this, undoAction](const QString &text) {
+		undoAction->setText(text.isEmpty() ? tr("Undo") : tr("Undo %1").arg(text));
+	});
+	m_ToolBar->addAction(undoAction);
+	addAction(undoAction);
+
+	QAction *redoAction = new QAction(tr("Redo"), this);
+	redoAction->setShortcut(QKeySequence::Redo);
+	redoAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+	redoAction->setEnabled(false);
+	connect(redoAction, &QAction::triggered, m_UndoJournal, &AnimationUndoJournal::redo);
+	connect(m_UndoJournal, &AnimationUndoJournal::canRedoChanged, redoAction, &QAction::setEnabled);
+	connect(m_UndoJournal, &AnimationUndoJournal::redoTextChanged, redoAction, [this, redoAction](const QString &text) {
+		redoAction->setText(text.isEmpty() ? tr("Redo") : tr("Redo %1").arg(text));
+	});
+	m_ToolBar->addAction(redoAction);
+	addAction(redoAction);
+
+	m_TimelineEditor->setUndoJournal(m_UndoJournal);
+	m_CurveEditor->setUndoJournal(m_UndoJournal);
+	m_TimelineEditor->setKeyframeIndex(m_KeyframeIndex);
+	m_CurveEditor->setKeyframeIndex(m_KeyframeIndex);
 
 	m_TrackTreeToolBar->addAction("Action 1");
 	m_TrackTreeToolBar->addAction("Action 2");
 
+	// Interpolation method of the selected tracks
+	QToolButton *interpolationButton = new QToolButton(m_TrackTreeToolBar);
+	interpolationButton->setText(tr("Interpolation"));
+	interpolationButton->setPopupMode(QToolButton::InstantPopup);
+	QMenu *interpolationMenu = new QMenu(interpolationButton);
+	const QPair<QString, AnimationInterpolation> interpolationMethods[] = {
+		{ tr("Step"), AnimationInterpolation::Step },
+		{ tr("Linear"), AnimationInterpolation::Linear },
+		{ tr("Bezier"), AnimationInterpolation::Bezier },
+		{ tr("TCB"), AnimationInterpolation::TCB },
+		{ tr("Ease In/Out"), AnimationInterpolation::EaseInOut },
+	};
+	for (const QPair<QString, AnimationInterpolation> &interpolationMethod : interpolationMethods)
+	{
+		AnimationInterpolation method = interpolationMethod.second;
+		connect(interpolationMenu->addAction(interpolationMethod.first), &QAction::triggered, this, [this, method]() {
+			convertInterpolationMethod(selectedTracks(), method);
+		});
+	}
+	interpolationButton->setMenu(interpolationMenu);
+	m_TrackTreeToolBar->addWidget(interpolationButton);
+
 	// Layout, first row for toolbar, second row a splitter
 	QVBoxLayout *mainLayout = new QVBoxLayout(this);
 	// mainLayout->setMargin(0);
@@ -138,6 +208,7 @@ AnimationEditor::AnimationEditor(QWidget *parent)
 
 	// Hide the header in the tree widget
 	m_TrackTreeWidget->setHeaderHidden(true);
+	m_TrackTreeWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);
 
 	// TODO:
 	// In the toolbar, add textboxes for the time and value of the last selected keyframe
@@ -147,6 +218,13 @@ AnimationEditor::AnimationEditor(QWidget *parent)
 
 AnimationEditor::~AnimationEditor()
 {
+	// Conversions that finish later are dropped
+	for (const std::shared_ptr<InterpolationConversion> &conversion : m_InterpolationConversions)
+	{
+		QMutexLocker lock(&conversion->Mutex);
+		conversion->Editor = nullptr;
+	}
+
 	// Clean up the root node and its children
 	deleteNodeAndChildren(&m_RootNode);
 }
@@ -186,8 +264,14 @@ void AnimationEditor::removeNode(AnimationNode *node)
 AnimationTrack *AnimationEditor::addTrack(AnimationNode *node)
 {
 	AnimationTrack *newTrack = new AnimationTrack(this);
-	newTrack->m_TreeWidgetItem = new QTreeWidgetItem(m_TrackTreeWidget);
-	newTrack->m_TreeWidgetItem->setText(0, "Track");
+	QTreeWidgetItem *treeWidgetItem = new QTreeWidgetItem(m_TrackTreeWidget);
+	treeWidgetItem->setText(0, newTrack->name());
+	connect(newTrack, &AnimationTrack::nameChanged, this, [treeWidgetItem](const QString &name) {
+		treeWidgetItem->setText(0, name);
+	});
+	newTrack->m_TreeWidgetItem = treeWidgetItem;
+	newTrack->setUndoJournal(m_UndoJournal);
+	newTrack->setKeyframeIndex(m_KeyframeIndex);
 
 	if (node == nullptr)
 		node = &m_RootNode;
@@ -282,12 +366,89 @@ void AnimationEditor::deleteNodeAndChildren(AnimationNode *node)
 		delete node;
 }
 
+const QList<AnimationTrack *> &AnimationEditor::tracks() const
+{
+	return m_Tracks;
+}
+
+void AnimationEditor::evaluatePose(double time, QVector<double> &out) const
+{
+	out.resize(m_Tracks.size());
+	AnimationTrack::evaluateTracks(m_Tracks.constData(), m_Tracks.size(), time, out.data());
+}
+
+AnimationUndoJournal *AnimationEditor::undoJournal() const
+{
+	return m_UndoJournal;
+}
+
+AnimationKeyframeIndex *AnimationEditor::keyframeIndex() const
+{
+	return m_KeyframeIndex;
+}
+
+void AnimationEditor::convertInterpolationMethod(const QList<AnimationTrack *> &tracks, AnimationInterpolation interpolationMethod)
+{
+	// The copies of the keyframes share their data with the tracks until they are converted
+	std::shared_ptr<InterpolationConversion> conversion = std::make_shared<InterpolationConversion>();
+	conversion->Editor = this;
+	conversion->InterpolationMethod = interpolationMethod;
+	for (AnimationTrack *track : tracks)
+	{
+		if (track->interpolationMethod() == interpolationMethod)
+			continue;
+		conversion->Tracks.append(track);
+		conversion->Snapshots.append(track->snapshot());
+		conversion->Keyframes.append(track->keyframeArray());
+		conversion->From.append(track->interpolationMethod());
+	}
+	if (conversion->Tracks.isEmpty())
+		return;
+
+	m_InterpolationConversions.append(conversion);
+	QThreadPool::globalInstance()->start([conversion]() {
+		AnimationTrack::convertKeyframeArrays(conversion->Keyframes.data(), conversion->From.constData(), conversion->Keyframes.size(), conversion->InterpolationMethod);
+		QMutexLocker lock(&conversion->Mutex);
+		if (AnimationEditor *editor = conversion->Editor)
+			QMetaObject::invokeMethod(editor, [editor, conversion]() { editor->applyInterpolationConversion(conversion); }, Qt::QueuedConnection);
+	});
+}
+
+void AnimationEditor::applyInterpolationConversion(const std::shared_ptr<InterpolationConversion> &conversion)
+{
+	m_InterpolationConversions.removeOne(conversion);
+
+	AnimationUndoJournal::CommandScope command(m_UndoJournal, tr("Change Interpolation"));
+	for (int i = 0; i < conversion->Tracks.size(); ++i)
+	{
+		AnimationTrack *track = conversion->Tracks[i];
+		if (!track)
+			continue; // Removed in the meantime
+		if (!track->isEditing() && track->snapshot() == conversion->Snapshots[i])
+			track->setKeyframes(conversion->Keyframes[i], conversion->InterpolationMethod);
+		else
+			track->convertInterpolationMethod(conversion->InterpolationMethod);
+	}
+}
+
+QList<AnimationTrack *> AnimationEditor::selectedTracks() const
+{
+	QList<AnimationTrack *> res;
+	for (AnimationTrack *track : m_Tracks)
+	{
+		if (track->m_TreeWidgetItem && track->m_TreeWidgetItem->isSelected())
+			res.append(track);
+	}
+	return res;
+}
+
 void AnimationEditor::updateTimelineTracks()
 {
 	QList<AnimationTrack *> tracks;
 	listTimelineTracks(tracks, &m_RootNode);
 	m_TimelineEditor->setAnimationTracks(tracks);
 	m_CurveEditor->setAnimationTracks(tracks);
+	m_Tracks = tracks;
 }
 
 void AnimationEditor::listTimelineTracks(QList<AnimationTrack *> &tracks, AnimationNode *node)
@@ -37,6 +37,8 @@ This library contains code that was generated using ChatGPT and Copilot.
 
 #include <QWidget>
 
+#include <memory>
+
 #include "AnimationTrack.h"
 
 class QToolBar;
@@ -46,6 +48,8 @@ class QTreeWidgetItem;
 class AnimationTimelineEditor;
 class AnimationCurveEditor;
 class AnimationTimeScrubber;
+class AnimationUndoJournal;
+class AnimationKeyframeIndex;
 class AnimationEditor;
 
 struct AnimationNode
@@ -71,6 +75,25 @@ public:
 	AnimationTrack *addTrack(AnimationNode *node = nullptr);
 	void removeTrack(AnimationTrack *track);
 
+	// All tracks in the node tree, flattened in the order used by evaluatePose
+	const QList<AnimationTrack *> &tracks() const;
+
+	// Evaluate every track at the given time, in parallel for large scenes, out[i] is the value of tracks()[i]
+	void evaluatePose(double time, QVector<double> &out) const;
+
+	// Journal recording the edits made to the tracks of the editor
+	AnimationUndoJournal *undoJournal() const;
+
+	// Index of the keyframe IDs of all the tracks in the editor
+	AnimationKeyframeIndex *keyframeIndex() const;
+
+	// Convert the tracks to another interpolation method, the keyframes are converted on the thread pool
+	// and applied as one undo command when done, tracks edited in the meantime are converted again as they are then
+	void convertInterpolationMethod(const QList<AnimationTrack *> &tracks, AnimationInterpolation interpolationMethod);
+
+	// Tracks selected in the track tree
+	QList<AnimationTrack *> selectedTracks() const;
+
 private:
 	QToolBar *m_ToolBar;
 	QToolBar *m_TrackTreeToolBar;
@@ -78,8 +101,16 @@ private:
 	AnimationTimelineEditor *m_TimelineEditor;
 	AnimationCurveEditor *m_CurveEditor;
 	AnimationTimeScrubber *m_TimeScrubber;
+	AnimationUndoJournal *m_UndoJournal;
+	AnimationKeyframeIndex *m_KeyframeIndex;
 
 	AnimationNode m_RootNode;
+	QList<AnimationTrack *> m_Tracks;
+
+	// Conversions running on the thread pool, detached from the editor when it is destroyed first
+	struct InterpolationConversion;
+	QList<std::shared_ptr<InterpolationConversion>> m_InterpolationConversions;
+	void applyInterpolationConversion(const std::shared_ptr<InterpolationConversion> &conversion);
 
 private:
 	// Helper functions
@@ -42,6 +42,9 @@ This library contains code that was generated using ChatGPT and Copilot.
 #include <QMenu>
 #include <QAction>
 #include <QScrollBar>
+#include <QRegion>
+#include <algorithm>
+#include <cstdlib>
 
 AnimationContextMenu::AnimationContextMenu(QWidget *parent) : QMenu(parent)
 {
@@ -60,6 +63,8 @@ AnimationTimelineEditor::AnimationTimelineEditor(QWidget *parent)
 {
 	setMouseTracking(true);
 	// setFocusPolicy(Qt::StrongFocus);
+	// Every pixel is painted, which lets scroll() move the painted rows instead of repainting them
+	setAttribute(Qt::WA_OpaquePaintEvent);
 	qApp->installEventFilter(this);
 	createContextMenu();
 }
@@ -159,10 +164,35 @@ void AnimationTimelineEditor::removeKeyframe()
 
 void AnimationTimelineEditor::setAnimationTracks(const QList<AnimationTrack *> &tracks)
 {
+	for (AnimationTrack *track : m_AnimationTracks)
+		disconnect(track, nullptr, this, nullptr);
+
 	m_AnimationTracks = tracks;
+
+	// Follow changes made to the tracks from elsewhere
+	for (AnimationTrack *track : m_AnimationTracks)
+		connect(track, &AnimationTrack::keyframesRangeChanged, this, &AnimationTimelineEditor::onKeyframesRangeChanged);
+
 	update();
 }
 
+void AnimationTimelineEditor::onKeyframesRangeChanged(double fromTime, double toTime, double minValue, double maxValue)
+{
+	Q_UNUSED(minValue);
+	Q_UNUSED(maxValue);
+
+	// Repaint the part of the row between the changed times, with room for the keyframes on either side
+	AnimationTrack *track = qobject_cast<AnimationTrack *>(sender());
+	QRect trackRect = visualTrackRectInWidgetSpace(track);
+	if (trackRect.isEmpty())
+		return;
+
+	int halfWidth = trackRect.height() / 2 + 1;
+	int fromX = timeToX(std::clamp(fromTime, m_FromTime, m_ToTime)) - halfWidth;
+	int toX = timeToX(std::clamp(toTime, m_FromTime, m_ToTime)) + halfWidth;
+	update(QRect(fromX, trackRect.y(), toX - fromX + 1, trackRect.height()) & rowsRect());
+}
+
 const QList<AnimationTrack *> &AnimationTimelineEditor::animationTracks() const
 {
 	return m_AnimationTracks;
@@ -191,6 +221,16 @@ QSet<ptrdiff_t> AnimationTimelineEditor::keyframeSelection() const
 	return m_SelectedKeyframes;
 }
 
+void AnimationTimelineEditor::setUndoJournal(AnimationUndoJournal *journal)
+{
+	m_UndoJournal = journal;
+}
+
+void AnimationTimelineEditor::setKeyframeIndex(AnimationKeyframeIndex *index)
+{
+	m_KeyframeIndex = index;
+}
+
 QRect AnimationTimelineEditor::visualTrackRect(AnimationTrack *track) const
 {
 	if (!track || !track->m_TreeWidgetItem)
@@ -227,7 +267,8 @@ QRect AnimationTimelineEditor::rowsRect()
 			if (track->m_TreeWidgetItem && track->m_TreeWidgetItem->treeWidget())
 			{
 				m_TreeWidget = track->m_TreeWidgetItem->treeWidget();
-				connect(m_TreeWidget->verticalScrollBar(), &QScrollBar::valueChanged, this, static_cast<void (AnimationTimelineEditor::*)()>(&AnimationTimelineEditor::update));
+				connect(m_TreeWidget->verticalScrollBar(), &QScrollBar::valueChanged, this, &AnimationTimelineEditor::onTreeScrolled);
+				m_RowsOffset = rowsOffset();
 				break;
 			}
 		}
@@ -244,12 +285,46 @@ QRect AnimationTimelineEditor::rowsRect()
 	return rect;
 }
 
+int AnimationTimelineEditor::rowsOffset() const
+{
+	// The tree lays out its items even when they are scrolled out of view
+	if (m_TreeWidget)
+	{
+		for (int i = 0; i < m_TreeWidget->topLevelItemCount(); ++i)
+		{
+			QTreeWidgetItem *item = m_TreeWidget->topLevelItem(i);
+			if (!item->isHidden())
+				return m_TreeWidget->visualItemRect(item).y();
+		}
+	}
+	return 0;
+}
+
+void AnimationTimelineEditor::onTreeScrolled()
+{
+	// Move the painted rows along with the tree, so that only the rows that came into view are painted
+	// The rubber band does not move with the rows, so the whole widget is repainted while selecting
+	int rowsOffset = this->rowsOffset();
+	int delta = rowsOffset - m_RowsOffset;
+	m_RowsOffset = rowsOffset;
+	QRect rect = rowsRect();
+	if (delta != 0 && std::abs(delta) < rect.height() && m_SelectionStart.isNull())
+		scroll(0, delta, rect);
+	else
+		update();
+}
+
 void AnimationTimelineEditor::paintEditorBackground(QPainter &painter)
 {
-	// Paint background
+	// Paint background, and the corners that the frame may leave out, as the widget paints all of its pixels
 	QRect bgRect = rowsRect();
 	QBrush baseBrush = palette().brush(QPalette::Base);
 	painter.fillRect(bgRect, baseBrush);
+	QRegion frameRegion = QRegion(0, 0, width(), height()) - QRegion(bgRect);
+	painter.save();
+	painter.setClipRegion(frameRegion);
+	painter.fillRect(QRect(0, 0, width(), height()), palette().brush(QPalette::Window));
+	painter.restore();
 
 	// Draw frame using QStyle
 	QStyleOptionFrame frameOption;
@@ -369,9 +444,8 @@ void AnimationTimelineEditor::paintKeyframe(QPainter &painter, const QRect &rect
 
 void AnimationTimelineEditor::paintEvent(QPaintEvent *event)
 {
-	Q_UNUSED(event);
-
 	QPainter painter(this);
+	m_RowsOffset = rowsOffset();
 
 	// Draw the background
 	paintEditorBackground(painter);
@@ -386,7 +460,7 @@ void AnimationTimelineEditor::paintEvent(QPaintEvent *event)
 	{
 		AnimationTrack *track = m_AnimationTracks[i];
 		QRect trackRect = visualTrackRectInWidgetSpace(track);
-		if (trackRect.isEmpty())
+		if (trackRect.isEmpty() || !trackRect.intersects(event->rect()))
 			continue;
 		trackRect = QRect(trackRect.x(), trackRect.y() + lineWidth, trackRect.width(), trackRect.height() - (lineWidth * 2));
 
@@ -407,13 +481,18 @@ void AnimationTimelineEditor::paintEvent(QPaintEvent *event)
 		painter.setPen(separatorPen);
 		painter.drawLine(trackRect.left(), trackRect.y() - 1, trackRect.right(), trackRect.y() - 1);
 
-		// Draw keyframes
-		for (AnimationTrack::KeyframeMap::const_iterator keyframe = track->keyframes().begin(); keyframe != track->keyframes().end(); ++keyframe)
+		// Draw the keyframes that overlap the painted rectangle
+		const AnimationKeyframeArray &keyframes = track->keyframeArray();
+		int halfWidth = trackRect.height() / 2 + lineWidth + 1;
+		int fromKeyframe = keyframes.lowerBound(xToTime(event->rect().left() - halfWidth));
+		int toKeyframe = keyframes.upperBound(xToTime(event->rect().right() + halfWidth));
+		for (int j = fromKeyframe; j < toKeyframe; ++j)
 		{
-			QRect keyframeRect = this->keyframeRect(track, keyframe.key());
-			bool isSelected = m_SelectedKeyframes.contains(keyframe.value().Id);
-			bool isHovered = (keyframe.value().Id == m_HoverKeyframe);
-			bool isPressed = (keyframe.value().Id == m_PressedKeyframe) || ((keyframe.value().Id == m_CurrentHoverKeyframe) && keyframe.value().Id == m_RightPressedKeyframe);
+			ptrdiff_t id = keyframes.id(j);
+			QRect keyframeRect = this->keyframeRect(track, keyframes.time(j));
+			bool isSelected = m_SelectedKeyframes.contains(id);
+			bool isHovered = (id == m_HoverKeyframe);
+			bool isPressed = (id == m_PressedKeyframe) || ((id == m_CurrentHoverKeyframe) && id == m_RightPressedKeyframe);
 			paintKeyframe(painter, keyframeRect, isSelected, isHovered, isPressed);
 		}
 	}
@@ -454,14 +533,13 @@ ptrdiff_t AnimationTimelineEditor::keyframeAtPosition(AnimationTrack *track, con
 {
 	if (!track)
 		return -1;
-	const AnimationTrack::KeyframeMap &keyframes = track->keyframes();
-	for (AnimationTrack::KeyframeMap::const_iterator it = keyframes.constEnd(); it != keyframes.constBegin();)
+	const AnimationKeyframeArray &keyframes = track->keyframeArray();
+	for (int i = keyframes.size() - 1; i >= 0; --i)
 	{
-		--it;
-		QRect keyframeRect = this->keyframeRect(track, it.key());
+		QRect keyframeRect = this->keyframeRect(track, keyframes.time(i));
 		if (keyframeRect.contains(pos))
 		{
-			return it.value().Id;
+			return keyframes.id(i);
 		}
 	}
 	return -1;
@@ -474,13 +552,6 @@ void AnimationTimelineEditor::mousePressEvent(QMouseEvent *event)
 
 	if (event->button() == Qt::LeftButton)
 	{
-		// Backup all tracks before modifying keyframes
-		m_BackupAnimationTracks.clear();
-		for (const AnimationTrack *track : m_AnimationTracks)
-		{
-			m_BackupAnimationTracks.append(track->keyframes());
-		}
-
 		bool ctrlHeld = event->modifiers() & Qt::ControlModifier;
 		bool clickedKeyframe = false;
 
@@ -575,13 +646,13 @@ void AnimationTimelineEditor::mousePressEvent(QMouseEvent *event)
 		{
 			// Abort track move on right click
 			m_SkipContextMenu = true;
-			for (int i = 0; i < m_AnimationTracks.size(); ++i)
+			QList<AnimationTrack *> tracks = m_DragSession.tracks();
 			{
-				AnimationTrack *track = m_AnimationTracks[i];
-				AnimationTrack::KeyframeMap &originalKeyframes = m_BackupAnimationTracks[i];
-				track->setKeyframes(originalKeyframes);
-				emit trackChanged(track);
+				AnimationUndoJournal::CommandScope command(m_UndoJournal, QString(), true);
+				m_DragSession.revert();
 			}
+			for (AnimationTrack *track : tracks)
+				emit trackChanged(track);
 		}
 	}
 
@@ -599,12 +670,13 @@ void AnimationTimelineEditor::updateMouseSelection(bool ctrlHeld)
 		for (AnimationTrack *track : m_AnimationTracks)
 		{
 			QRect trackRect = visualTrackRectInWidgetSpace(track);
-			for (AnimationTrack::KeyframeMap::const_iterator keyframe = track->keyframes().begin(); keyframe != track->keyframes().end(); ++keyframe)
+			const AnimationKeyframeArray &keyframes = track->keyframeArray();
+			for (int i = 0; i < keyframes.size(); ++i)
 			{
-				QRect keyframeRect = this->keyframeRect(track, keyframe.key());
+				QRect keyframeRect = this->keyframeRect(track, keyframes.time(i));
 				if (selectionRect.intersects(keyframeRect))
 				{
-					newSelectedKeyframes.insert(keyframe.value().Id);
+					newSelectedKeyframes.insert(keyframes.id(i));
 				}
 			}
 		}
@@ -629,27 +701,19 @@ void AnimationTimelineEditor::mouseMoveEvent(QMouseEvent *event)
 	{
 		double timeDelta = xToTime(event->pos().x()) - xToTime(m_TrackMoveStart.x());
 
-		for (int i = 0; i < m_AnimationTracks.size(); ++i)
+		// Move the selected keyframes relative to where they were when the drag started
+		// Every step of the drag is merged into the command recorded by the first one
+		bool firstStep = !m_DragSession.isActive();
+		if (firstStep && m_KeyframeIndex)
+			m_DragSession.begin(*m_KeyframeIndex, m_SelectedKeyframes);
+		else if (firstStep)
+			m_DragSession.begin(m_AnimationTracks, m_SelectedKeyframes);
 		{
-			AnimationTrack *track = m_AnimationTracks[i];
-			AnimationTrack::KeyframeMap &originalKeyframes = m_BackupAnimationTracks[i];
-
-			// Restore the original tracks before modifying keyframes
-			track->setKeyframes(originalKeyframes);
-			bool changed = false;
-
-			for (AnimationTrack::KeyframeMap::const_iterator keyframe = originalKeyframes.begin(); keyframe != originalKeyframes.end(); ++keyframe)
-			{
-				if (m_SelectedKeyframes.contains(keyframe.value().Id))
-				{
-					double newTime = keyframe.key() + timeDelta;
-					track->moveKeyframe(keyframe.key(), newTime);
-					changed = true;
-				}
-			}
-
-			emit trackChanged(track);
+			AnimationUndoJournal::CommandScope command(m_UndoJournal, tr("Move Keyframes"), !firstStep);
+			m_DragSession.apply(timeDelta, 0.0);
 		}
+		for (AnimationTrack *track : m_DragSession.tracks())
+			emit trackChanged(track);
 
 		m_HoverKeyframe = -1;
 		m_HoverTrack = nullptr;
@@ -712,7 +776,7 @@ void AnimationTimelineEditor::mouseReleaseEvent(QMouseEvent *event)
 	m_TrackMoveStart = QPoint();
 	m_PressedKeyframe = -1;
 	m_RightPressedKeyframe = -1;
-	m_BackupAnimationTracks.clear();
+	m_DragSession.commit();
 	// updateMouseHover(event->pos());
 	mouseMoveEvent(event);
 	update();
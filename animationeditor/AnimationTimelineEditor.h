@@ -41,6 +41,9 @@ This library contains code that was generated using ChatGPT and Copilot.
 #include <QMenu>
 
 #include "AnimationTrack.h"
+#include "AnimationDragSession.h"
+#include "AnimationUndoJournal.h"
+#include "AnimationKeyframeIndex.h"
 
 class QMouseEvent;
 class QWheelEvent;
@@ -78,6 +81,12 @@ public:
 	void setKeyframeSelection(const QSet<ptrdiff_t> &selection);
 	QSet<ptrdiff_t> keyframeSelection() const;
 
+	// Set the journal that records the edits made in the editor, may be null
+	void setUndoJournal(AnimationUndoJournal *journal);
+
+	// Set the index used to find the selected keyframes, may be null
+	void setKeyframeIndex(AnimationKeyframeIndex *index);
+
 	QRect visualTrackRect(AnimationTrack *track) const;
 
 signals:
@@ -107,12 +116,19 @@ private slots:
 	void removeKeyframe();
 	void onContextMenuClosed();
 
+	// Track changes
+	void onKeyframesRangeChanged(double fromTime, double toTime, double minValue, double maxValue);
+
+	// Tree scrolling
+	void onTreeScrolled();
+
 private:
 	// Create the context menu and actions
 	void createContextMenu();
 
 	// Paint and layout functions
 	QRect rowsRect();
+	int rowsOffset() const;
 	QRect visualTrackRectInWidgetSpace(AnimationTrack *track);
 	QRect keyframeRect(AnimationTrack *track, double time);
 	AnimationTrack *trackAtPosition(const QPoint &pos);
@@ -134,14 +150,17 @@ private:
 	QAction *m_AddKeyframeAction = nullptr;
 	QAction *m_RemoveKeyframeAction = nullptr;
 
-	// Associated QTreeWidget
+	// Associated QTreeWidget, and the vertical offset of its rows as they are painted
 	QTreeWidget *m_TreeWidget = nullptr;
+	int m_RowsOffset = 0;
 
 	// List of animation tracks
 	QList<AnimationTrack *> m_AnimationTracks;
 
-	// Original animation tracks backup
-	QList<AnimationTrack::KeyframeMap> m_BackupAnimationTracks;
+	// Keyframes being dragged, the journal recording the drag, and the index to find the keyframes
+	AnimationDragSession m_DragSession;
+	AnimationUndoJournal *m_UndoJournal = nullptr;
+	AnimationKeyframeIndex *m_KeyframeIndex = nullptr;
 
 	// Keyframe selection and backup
 	QSet<ptrdiff_t> m_SelectedKeyframes;